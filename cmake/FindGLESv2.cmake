@@ -0,0 +1,20 @@
+#
+# Try to find GLESv2 library and include path.
+# OpenGL ES 3 is provided by the same library.
+# Once done this will define
+#
+# GLESv2_FOUND
+# GLESv2_INCLUDE_PATH
+# GLESv2_LIBRARY
+#
+
+find_path(GLESv2_INCLUDE_DIR GLES2/gl2.h)
+find_library(GLESv2_LIBRARY NAMES GLESv2)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(GLESv2 DEFAULT_MSG GLESv2_LIBRARY GLESv2_INCLUDE_DIR)
+
+add_library(GLESv2::GLESv2 IMPORTED UNKNOWN)
+set_target_properties(GLESv2::GLESv2 PROPERTIES
+    INTERFACE_INCLUDE_DIRECTORIES ${GLESv2_INCLUDE_DIR}
+    IMPORTED_LOCATION ${GLESv2_LIBRARY})
@@ -0,0 +1,126 @@
+#include "imgui.h" // necessary for ImGui::*, imgui-SFML.h doesn't include imgui.h
+
+#include "imgui-SFML.h" // for ImGui::SFML::* functions and SFML-specific overloads
+
+#include <SFML/Graphics.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// Shows the images of a folder (the first argument, or the working directory) as a grid of
+// thumbnails loaded in the background, along with the longest frame of the last second.
+namespace
+{
+constexpr float thumbnailSize = 96.f;
+
+[[nodiscard]] bool isImageFile(const std::filesystem::path& path)
+{
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(),
+                   extension.end(),
+                   extension.begin(),
+                   [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" ||
+           extension == ".tga" || extension == ".gif" || extension == ".psd" || extension == ".hdr";
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const std::filesystem::path folder = argc > 1 ? argv[1] : ".";
+
+    std::vector<std::filesystem::path> files;
+    std::error_code                    error;
+    for (const auto& file : std::filesystem::directory_iterator(folder, error))
+    {
+        if (file.is_regular_file() && isImageFile(file.path()))
+            files.push_back(file.path());
+    }
+    std::sort(files.begin(), files.end());
+
+    sf::RenderWindow window(sf::VideoMode({1280, 720}), "Image browser");
+    window.setFramerateLimit(60);
+    if (!ImGui::SFML::Init(window))
+        return -1;
+
+    ImGui::SFML::EnableAsyncImages();
+    std::vector<ImGui::SFML::AsyncImage> images;
+    images.reserve(files.size());
+    for (const std::filesystem::path& file : files)
+        images.push_back(ImGui::SFML::GetAsyncImage(file));
+
+    sf::Clock deltaClock;
+    sf::Clock secondClock;
+    sf::Time  longestFrame;
+    sf::Time  shownLongestFrame;
+    while (window.isOpen())
+    {
+        while (const auto event = window.pollEvent())
+        {
+            ImGui::SFML::ProcessEvent(window, *event);
+
+            if (event->is<sf::Event::Closed>())
+            {
+                window.close();
+            }
+        }
+
+        const sf::Time dt = deltaClock.restart();
+        longestFrame      = std::max(longestFrame, dt);
+        if (secondClock.getElapsedTime() >= sf::seconds(1))
+        {
+            shownLongestFrame = std::exchange(longestFrame, sf::Time::Zero);
+            secondClock.restart();
+        }
+
+        ImGui::SFML::Update(window, dt);
+
+        ImGui::SetNextWindowPos({0.f, 0.f});
+        ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+        ImGui::Begin("Images", nullptr, ImGuiWindowFlags_NoDecoration);
+        ImGui::Text("%zu images in %s, longest frame %d ms",
+                    images.size(),
+                    folder.string().c_str(),
+                    static_cast<int>(shownLongestFrame.asMilliseconds()));
+
+        // only the visible rows are submitted, the others are cancelled or released after a while
+        const ImVec2 spacing  = ImGui::GetStyle().ItemSpacing;
+        const float  cellSize = thumbnailSize + spacing.x;
+        const int    columns  = std::max(1, static_cast<int>(ImGui::GetContentRegionAvail().x / cellSize));
+        const int    rows     = (static_cast<int>(images.size()) + columns - 1) / columns;
+        ImGui::BeginChild("Grid");
+        ImGuiListClipper clipper;
+        clipper.Begin(rows, thumbnailSize + spacing.y);
+        while (clipper.Step())
+        {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+            {
+                for (int column = 0; column < columns; ++column)
+                {
+                    const auto index = static_cast<std::size_t>(row * columns + column);
+                    if (index >= images.size())
+                        break;
+
+                    if (column > 0)
+                        ImGui::SameLine();
+                    ImGui::Image(images[index], {thumbnailSize, thumbnailSize});
+                    if (ImGui::IsItemHovered())
+                        ImGui::SetTooltip("%s", files[index].filename().string().c_str());
+                }
+            }
+        }
+        ImGui::EndChild();
+        ImGui::End();
+
+        window.clear();
+        ImGui::SFML::Render(window);
+        window.display();
+    }
+
+    ImGui::SFML::Shutdown();
+}
@@ -0,0 +1,104 @@
+#include "imgui.h" // necessary for ImGui::*, imgui-SFML.h doesn't include imgui.h
+
+#include "imgui-SFML.h" // for ImGui::SFML::* functions and SFML-specific overloads
+
+#include <SFML/Graphics.hpp>
+
+#include <cmath>
+#include <iostream>
+
+// Renders a node graph of more than 1M vertices in a single draw list into an offscreen render
+// texture, and prints the average CPU time spent building and rendering it along with the number
+// of batches the list was split into. Build with IMGUI_SFML_32BIT_INDICES to draw it as a single
+// batch, 16-bit indices split it every 64k vertices.
+namespace
+{
+constexpr int frames       = 300;
+constexpr int warmUpFrames = 30;
+constexpr int nodes        = 50'000;
+
+void buildNodeGraph(float time)
+{
+    ImGui::SetNextWindowPos({0.f, 0.f});
+    ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+    ImGui::Begin("Node graph", nullptr, ImGuiWindowFlags_NoDecoration);
+
+    // 4 vertices for each node and 21 for each anti-aliased link
+    ImDrawList*  drawList = ImGui::GetWindowDrawList();
+    const ImVec2 origin   = ImGui::GetCursorScreenPos();
+    for (int i = 0; i < nodes; ++i)
+    {
+        const float x = origin.x + static_cast<float>(i % 250) * 5.f;
+        const float y = origin.y + static_cast<float>(i / 250) * 4.f + std::sin(time + static_cast<float>(i)) * 2.f;
+        drawList->AddRectFilled({x, y}, {x + 3.f, y + 2.f}, IM_COL32(90, 120, 200, 255));
+        drawList->AddBezierCubic({x + 3.f, y + 1.f},
+                                 {x + 6.f, y + 1.f},
+                                 {x + 4.f, y + 5.f},
+                                 {x + 8.f, y + 5.f},
+                                 IM_COL32(220, 220, 220, 255),
+                                 1.f,
+                                 6);
+    }
+
+    ImGui::End();
+}
+} // namespace
+
+int main()
+{
+    // the window is never opened, everything is drawn into the render texture
+    sf::Window         window;
+    sf::RenderTexture  target({1280, 720});
+    const sf::Vector2f displaySize(target.getSize());
+    if (!ImGui::SFML::Init(window, displaySize))
+        return -1;
+
+    sf::Time buildTime;
+    sf::Time renderTime;
+    int      vertices = 0;
+    int      batches  = 0;
+    for (int frame = 0; frame < warmUpFrames + frames; ++frame)
+    {
+        ImGui::SFML::Update(sf::Vector2i(), displaySize, sf::milliseconds(16));
+
+        sf::Clock buildClock;
+        buildNodeGraph(static_cast<float>(frame) / 60.f);
+        const sf::Time built = buildClock.getElapsedTime();
+
+        target.clear();
+        sf::Clock renderClock;
+        ImGui::SFML::Render(target);
+        const sf::Time rendered = renderClock.getElapsedTime();
+        target.display();
+
+        if (frame < warmUpFrames)
+            continue;
+
+        buildTime += built;
+        renderTime += rendered;
+
+        // a new batch starts whenever the renderer has to rebase the vertex buffer
+        const ImDrawData* drawData = ImGui::GetDrawData();
+        vertices                   = drawData->TotalVtxCount;
+        batches                    = 0;
+        for (const ImDrawList* drawList : drawData->CmdLists)
+        {
+            unsigned int vtxOffset = 0;
+            ++batches;
+            for (const ImDrawCmd& cmd : drawList->CmdBuffer)
+            {
+                if (cmd.VtxOffset != vtxOffset)
+                {
+                    vtxOffset = cmd.VtxOffset;
+                    ++batches;
+                }
+            }
+        }
+    }
+
+    std::cout << sizeof(ImDrawIdx) * 8 << "-bit indices: " << vertices << " vertices in " << batches
+              << " batches, build " << buildTime.asMicroseconds() / frames << " us, render "
+              << renderTime.asMicroseconds() / frames << " us\n";
+
+    ImGui::SFML::Shutdown();
+}
@@ -0,0 +1,120 @@
+#include "imgui.h" // necessary for ImGui::*, imgui-SFML.h doesn't include imgui.h
+
+#include "imgui-SFML.h" // for ImGui::SFML::* functions and SFML-specific overloads
+
+#include <SFML/Graphics.hpp>
+
+#include <cmath>
+#include <iostream>
+
+// Renders a UI heavy in vertices with every draw data upload strategy in turn, and prints the
+// average CPU time spent in Render and the GPU time of the UI pass for each of them. Upload
+// strategies only apply to the OpenGL ES shader renderer (IMGUI_SFML_RENDERER=GLES2 or GLES3).
+namespace
+{
+constexpr int framesPerStrategy = 600;
+constexpr int warmUpFrames      = 60; // buffers are (re)created and drivers settle in these
+
+const char* getStrategyName(ImGui::SFML::BufferUploadStrategy strategy)
+{
+    switch (strategy)
+    {
+        case ImGui::SFML::BufferUploadStrategy::Orphan:
+            return "Orphan";
+        case ImGui::SFML::BufferUploadStrategy::SubData:
+            return "SubData";
+        case ImGui::SFML::BufferUploadStrategy::PersistentRing:
+            return "PersistentRing";
+        case ImGui::SFML::BufferUploadStrategy::ClientMemory:
+            return "ClientMemory";
+    }
+    return "";
+}
+
+void buildHeavyUI(float time)
+{
+    ImGui::SetNextWindowPos({0.f, 0.f});
+    ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+    ImGui::Begin("Benchmark", nullptr, ImGuiWindowFlags_NoDecoration);
+
+    // about 200k vertices of anti-aliased lines
+    ImDrawList*  drawList = ImGui::GetWindowDrawList();
+    const ImVec2 origin   = ImGui::GetCursorScreenPos();
+    const ImVec2 size     = ImGui::GetContentRegionAvail();
+    for (int curve = 0; curve < 20; ++curve)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            const float x = size.x * static_cast<float>(i) / 1000.f;
+            const float y = size.y * (0.5f + 0.4f * std::sin(x * 0.02f + time + static_cast<float>(curve)));
+            drawList->PathLineTo({origin.x + x, origin.y + y});
+        }
+        drawList->PathStroke(IM_COL32(255, 255 - curve * 10, curve * 10, 255), ImDrawFlags_None, 1.5f);
+    }
+
+    for (int i = 0; i < 200; ++i)
+        ImGui::Text("Line of text number %d, to stream glyph quads as well", i);
+
+    ImGui::End();
+}
+} // namespace
+
+int main()
+{
+    sf::RenderWindow window(sf::VideoMode({1280, 720}), "ImGui-SFML streaming benchmark");
+    if (!ImGui::SFML::Init(window))
+        return -1;
+    ImGui::SFML::SetGpuTimerEnabled(true);
+
+    constexpr ImGui::SFML::BufferUploadStrategy strategies[] = {ImGui::SFML::BufferUploadStrategy::Orphan,
+                                                                ImGui::SFML::BufferUploadStrategy::SubData,
+                                                                ImGui::SFML::BufferUploadStrategy::PersistentRing};
+
+    sf::Clock deltaClock;
+    sf::Clock runClock;
+    for (const ImGui::SFML::BufferUploadStrategy strategy : strategies)
+    {
+        ImGui::SFML::SetBufferUploadStrategy(strategy);
+
+        sf::Time renderTime;
+        sf::Time gpuTime;
+        int      gpuSamples = 0;
+        for (int frame = 0; frame < warmUpFrames + framesPerStrategy && window.isOpen(); ++frame)
+        {
+            while (const auto event = window.pollEvent())
+            {
+                ImGui::SFML::ProcessEvent(window, *event);
+                if (event->is<sf::Event::Closed>())
+                    window.close();
+            }
+
+            ImGui::SFML::Update(window, deltaClock.restart());
+            buildHeavyUI(runClock.getElapsedTime().asSeconds());
+
+            window.clear();
+            sf::Clock renderClock;
+            ImGui::SFML::Render(window);
+            const sf::Time elapsed = renderClock.getElapsedTime();
+            window.display();
+
+            if (frame < warmUpFrames)
+                continue;
+
+            renderTime += elapsed;
+            if (const auto gpuRenderTime = ImGui::SFML::GetGpuRenderTime())
+            {
+                gpuTime += *gpuRenderTime;
+                ++gpuSamples;
+            }
+        }
+
+        const char* inEffect = getStrategyName(ImGui::SFML::GetBufferUploadStrategy()); // after fallbacks
+        std::cout << getStrategyName(strategy) << " (in effect: " << inEffect
+                  << "): Render " << renderTime.asMicroseconds() / framesPerStrategy << " us";
+        if (gpuSamples > 0)
+            std::cout << ", GPU " << gpuTime.asMicroseconds() / gpuSamples << " us";
+        std::cout << '\n';
+    }
+
+    ImGui::SFML::Shutdown();
+}
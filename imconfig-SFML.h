@@ -32,3 +32,68 @@
                          static_cast<std::uint8_t>(z * 255.f),                                  \
                          static_cast<std::uint8_t>(w * 255.f));                                 \
     }
+
+#ifdef IMGUI_SFML_32BIT_INDICES
+// A single draw list can then hold more than 64k vertices, without being split into several
+// batches with vertex offsets. OpenGL ES 2 needs OES_element_index_uint for it.
+#define ImDrawIdx unsigned int
+#endif
+
+#ifdef IMGUI_SFML_COMPACT_VERTICES
+// Compact vertex layout: 12 bytes per vertex instead of 20. Positions are stored as 16-bit fixed
+// point with a quarter pixel precision (so they're clamped to +/-8191 pixels), texture coordinates
+// with 12 fractional bits, which keeps them exact for textures up to 4096 texels wide and lets
+// them repeat textures up to 8 times (clamped to +/-7.99). ImGui-SFML's renderers consume these
+// directly.
+namespace ImGui::SFML
+{
+template <int Steps>
+struct PackedFloat
+{
+    static constexpr int steps = Steps; // number of steps per unit
+
+    std::int16_t value;
+
+    PackedFloat& operator=(float v)
+    {
+        const float scaled  = v * static_cast<float>(Steps);
+        const float clamped = scaled > -32767.f ? (scaled < 32767.f ? scaled : 32767.f) : -32767.f;
+
+        value = static_cast<std::int16_t>(clamped < 0.f ? clamped - 0.5f : clamped + 0.5f);
+        return *this;
+    }
+
+    operator float() const
+    {
+        return static_cast<float>(value) / static_cast<float>(Steps);
+    }
+};
+
+template <typename Vec2, int Steps>
+struct PackedVec2
+{
+    PackedFloat<Steps> x;
+    PackedFloat<Steps> y;
+
+    PackedVec2& operator=(const Vec2& v)
+    {
+        x = v.x;
+        y = v.y;
+        return *this;
+    }
+
+    operator Vec2() const
+    {
+        return Vec2(x, y);
+    }
+};
+} // namespace ImGui::SFML
+
+#define IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT       \
+    struct ImDrawVert                               \
+    {                                               \
+        ImGui::SFML::PackedVec2<ImVec2, 4>    pos; \
+        ImGui::SFML::PackedVec2<ImVec2, 4096> uv;  \
+        ImU32                                 col; \
+    }
+#endif
@@ -1,26 +1,65 @@
 #include "imgui-SFML.h"
 #include <imgui.h>
 
+// imgui_draw.cpp compiles its copy of stb_rect_pack as static, so the image atlas needs its own
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <imstb_rectpack.h>
+
 #include <SFML/Config.hpp>
 #include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/RenderTexture.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/Shader.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/View.hpp>
+#if defined(IMGUI_SFML_RENDERER_GLES3)
+#include <GLES3/gl3.h>
+#elif defined(IMGUI_SFML_RENDERER_GLES2)
+#include <GLES2/gl2.h>
+#else
 #include <SFML/OpenGL.hpp>
+#endif
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <SFML/System/Utf.hpp>
 #include <SFML/Window/Clipboard.hpp>
+#include <SFML/Window/Context.hpp>
 #include <SFML/Window/Cursor.hpp>
 #include <SFML/Window/Event.hpp>
 #include <SFML/Window/Touch.hpp>
 #include <SFML/Window/Window.hpp>
 
 #include <cassert>
+#include <cfloat>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <istream>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #if defined(__APPLE__)
@@ -115,6 +154,31 @@ int closeKeyboardIME()
 
 static_assert(sizeof(GLuint) <= sizeof(ImTextureID), "ImTextureID is not large enough to fit GLuint.");
 
+#if defined(IMGUI_SFML_RENDERER_GLES2) || defined(IMGUI_SFML_RENDERER_GLES3)
+#define IMGUI_SFML_SHADER_RENDERER
+#ifndef APIENTRY
+#define APIENTRY GL_APIENTRY
+#endif
+#endif
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+
 namespace
 {
 // various helper functions
@@ -157,26 +221,314 @@ namespace
     return glTextureHandle;
 }
 
-struct SpriteTextureData
+// Registered textures are encoded in ImTextureID with the top bit set, the lower half holding
+// the registry index and the rest a generation which changes whenever an index is reused.
+// Raw GL texture names never have the top bit set.
+using TextureIDBits = std::conditional_t<sizeof(ImTextureID) >= sizeof(std::uint64_t), std::uint64_t, std::uint32_t>;
+
+constexpr unsigned int  TextureIDBitCount     = sizeof(TextureIDBits) * 8;
+constexpr unsigned int  TextureIndexBitCount  = TextureIDBitCount / 2;
+constexpr TextureIDBits RegisteredTextureTag  = TextureIDBits{1} << (TextureIDBitCount - 1);
+constexpr TextureIDBits TextureIndexMask      = (TextureIDBits{1} << TextureIndexBitCount) - 1;
+constexpr TextureIDBits TextureGenerationMask = (RegisteredTextureTag - 1) >> TextureIndexBitCount;
+
+struct AtlasSlot
+{
+    std::size_t   page{0};
+    std::uint32_t pageGeneration{0}; // slot is stale once the page has been evicted
+    sf::Vector2u  position;
+    sf::Vector2u  size;
+    GLuint        sourceHandle{0};
+    bool          smooth{false};
+};
+
+struct RegisteredTexture
+{
+    const sf::Texture* texture{nullptr}; // nullptr while the slot is free
+    TextureIDBits      generation{0};
+    GLuint             nativeHandle{0}; // refreshed every time the texture is submitted
+
+    std::optional<ImGui::SFML::TextureSampler> sampler;
+    std::optional<AtlasSlot>                   atlasSlot;
+};
+
+struct TextureRegistry
+{
+    std::vector<RegisteredTexture>                        entries;
+    std::vector<std::uint32_t>                            freeIndices;
+    std::unordered_map<const sf::Texture*, std::uint32_t> indices;
+};
+
+TextureRegistry s_textureRegistry;
+
+[[nodiscard]] ImTextureID encodeRegisteredTextureID(std::uint32_t index, TextureIDBits generation)
+{
+    const TextureIDBits bits = RegisteredTextureTag | (generation << TextureIndexBitCount) | index;
+    ImTextureID         textureID{};
+    std::memcpy(&textureID, &bits, sizeof(TextureIDBits));
+    return textureID;
+}
+
+[[nodiscard]] ImTextureID getTextureID(const sf::Texture& texture)
+{
+    if (!s_textureRegistry.indices.empty())
+    {
+        const auto found = s_textureRegistry.indices.find(&texture);
+        if (found != s_textureRegistry.indices.end())
+        {
+            RegisteredTexture& entry = s_textureRegistry.entries[found->second];
+            entry.nativeHandle       = texture.getNativeHandle();
+            return encodeRegisteredTextureID(found->second, entry.generation);
+        }
+    }
+
+    return convertGLTextureHandleToImTextureID(texture.getNativeHandle());
+}
+
+// Returns the GL texture to bind for a draw command, or nothing if it refers to a texture which
+// has been unregistered since the command was recorded
+[[nodiscard]] std::optional<GLuint> resolveTextureID(ImTextureID textureID, const ImGui::SFML::TextureSampler*& sampler)
+{
+    sampler            = nullptr;
+    TextureIDBits bits = 0;
+    std::memcpy(&bits, &textureID, sizeof(TextureIDBits));
+    if ((bits & RegisteredTextureTag) == 0)
+        return convertImTextureIDToGLTextureHandle(textureID);
+
+    const auto          index      = static_cast<std::size_t>(bits & TextureIndexMask);
+    const TextureIDBits generation = (bits >> TextureIndexBitCount) & TextureGenerationMask;
+
+    const bool alive = index < s_textureRegistry.entries.size() && s_textureRegistry.entries[index].texture &&
+                       s_textureRegistry.entries[index].generation == generation;
+    assert(alive && "Texture was unregistered while a draw list still referenced it");
+    if (!alive)
+        return std::nullopt;
+
+    const RegisteredTexture& entry = s_textureRegistry.entries[index];
+    assert(glIsTexture(entry.nativeHandle) && "Registered texture was destroyed without calling UnregisterTexture");
+    if (entry.sampler)
+        sampler = &*entry.sampler;
+    return entry.nativeHandle;
+}
+
+struct TextureData
 {
     ImVec2      uv0;
     ImVec2      uv1;
     ImTextureID textureID{};
 };
 
-[[nodiscard]] SpriteTextureData getSpriteTextureData(const sf::Sprite& sprite)
+// Returns the id to draw texture with and maps uv0/uv1 into the atlas if it has been atlased
+[[nodiscard]] TextureData getTextureData(const sf::Texture& texture, ImVec2 uv0 = ImVec2(0, 0), ImVec2 uv1 = ImVec2(1, 1));
+
+[[nodiscard]] ImU32 toImU32(sf::Color c)
+{
+    return IM_COL32(c.r, c.g, c.b, c.a);
+}
+
+// Reserves room for up to count primitives, in chunks which still fit 16-bit indices. Returns the
+// number of primitives reserved.
+[[nodiscard]] std::size_t reservePrimitives(ImDrawList& drawList, std::size_t count, std::size_t vtxCount, std::size_t idxCount)
+{
+    const std::size_t maxPrimitives = sizeof(ImDrawIdx) == 2 ? 0xFFFF / vtxCount : (std::size_t{1} << 22) / vtxCount;
+
+    const std::size_t primitives = std::min(count, maxPrimitives);
+    drawList.PrimReserve(static_cast<int>(primitives * idxCount), static_cast<int>(primitives * vtxCount));
+    return primitives;
+}
+
+[[nodiscard]] std::size_t reserveQuads(ImDrawList& drawList, std::size_t count)
+{
+    return reservePrimitives(drawList, count, 4, 6);
+}
+
+// Writes a quad into space reserved with reserveQuads. Corners are in clockwise order starting at
+// the top-left one.
+void writeQuad(ImDrawList& drawList, const ImVec2 (&corners)[4], const ImVec2& uvMin, const ImVec2& uvMax, ImU32 color)
+{
+    ImDrawVert* vtx = drawList._VtxWritePtr;
+    ImDrawIdx*  idx = drawList._IdxWritePtr;
+
+    const ImVec2 uvs[4] = {uvMin, ImVec2(uvMax.x, uvMin.y), uvMax, ImVec2(uvMin.x, uvMax.y)};
+    for (int i = 0; i < 4; ++i)
+    {
+        vtx[i].pos = corners[i];
+        vtx[i].uv  = uvs[i];
+        vtx[i].col = color;
+    }
+
+    const auto base = static_cast<ImDrawIdx>(drawList._VtxCurrentIdx);
+    idx[0]          = base;
+    idx[1]          = static_cast<ImDrawIdx>(base + 1);
+    idx[2]          = static_cast<ImDrawIdx>(base + 2);
+    idx[3]          = base;
+    idx[4]          = static_cast<ImDrawIdx>(base + 2);
+    idx[5]          = static_cast<ImDrawIdx>(base + 3);
+
+    drawList._VtxWritePtr += 4;
+    drawList._IdxWritePtr += 6;
+    drawList._VtxCurrentIdx += 4;
+}
+
+void writeRectQuad(ImDrawList& drawList, const sf::Vector2f& min, const sf::Vector2f& max, const ImVec2& uv, ImU32 color)
+{
+    const ImVec2 corners[4] = {ImVec2(min.x, min.y), ImVec2(max.x, min.y), ImVec2(max.x, max.y), ImVec2(min.x, max.y)};
+    writeQuad(drawList, corners, uv, uv, color);
+}
+
+// Writes a segment from a to b as a quad, without ImGui's anti-aliased fringe
+void writeSegmentQuad(ImDrawList&         drawList,
+                      const sf::Vector2f& a,
+                      const sf::Vector2f& b,
+                      float               halfWidth,
+                      const ImVec2&       uv,
+                      ImU32               color)
+{
+    sf::Vector2f normal(a.y - b.y, b.x - a.x);
+    const float  length = std::sqrt(normal.x * normal.x + normal.y * normal.y);
+    if (length > 0.f)
+        normal = normal * (halfWidth / length);
+
+    const ImVec2 corners[4] = {toImVec2(a + normal), toImVec2(b + normal), toImVec2(b - normal), toImVec2(a - normal)};
+    writeQuad(drawList, corners, uv, uv, color);
+}
+
+// Writes the outline of a rect, inset by thickness, as a ring of 8 vertices (outer corners followed
+// by inner corners) into space reserved with reservePrimitives(drawList, count, 8, 24)
+void writeRectRing(ImDrawList&         drawList,
+                   const sf::Vector2f& min,
+                   const sf::Vector2f& max,
+                   float               thickness,
+                   const ImVec2&       uv,
+                   ImU32               color)
+{
+    constexpr ImDrawIdx ringIndices[24] = {0, 1, 5, 0, 5, 4, 1, 2, 6, 1, 6, 5, 2, 3, 7, 2, 7, 6, 3, 0, 4, 3, 4, 7};
+
+    const float  inset   = std::min({thickness, (max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f});
+    const ImVec2 ring[8] = {ImVec2(min.x, min.y),
+                            ImVec2(max.x, min.y),
+                            ImVec2(max.x, max.y),
+                            ImVec2(min.x, max.y),
+                            ImVec2(min.x + inset, min.y + inset),
+                            ImVec2(max.x - inset, min.y + inset),
+                            ImVec2(max.x - inset, max.y - inset),
+                            ImVec2(min.x + inset, max.y - inset)};
+
+    ImDrawVert* vtx = drawList._VtxWritePtr;
+    for (int i = 0; i < 8; ++i)
+    {
+        vtx[i].pos = ring[i];
+        vtx[i].uv  = uv;
+        vtx[i].col = color;
+    }
+
+    const auto base = static_cast<ImDrawIdx>(drawList._VtxCurrentIdx);
+    for (int i = 0; i < 24; ++i)
+        drawList._IdxWritePtr[i] = static_cast<ImDrawIdx>(base + ringIndices[i]);
+
+    drawList._VtxWritePtr += 8;
+    drawList._IdxWritePtr += 24;
+    drawList._VtxCurrentIdx += 8;
+}
+
+// Smallest and largest sample of a range of a SampleSeries
+struct SampleRange
+{
+    float min{FLT_MAX};
+    float max{-FLT_MAX};
+};
+
+// Reduces samples [first, last) with blocks of the largest pyramid levels which fit in the range,
+// so that only a few blocks per level are read at both ends. Blocks of level n cover 2^(n+1) samples.
+[[nodiscard]] SampleRange reduceSamples(const ImGui::SampleSeries& series, std::size_t first, std::size_t last)
+{
+    SampleRange range;
+    const auto  addBlock = [&series, &range](std::size_t depth, std::size_t index)
+    {
+        if (depth == 0)
+        {
+            range.min = std::min(range.min, series.samples[index]);
+            range.max = std::max(range.max, series.samples[index]);
+            return;
+        }
+        const ImGui::SampleSeries::Level& level = series.levels[depth - 1];
+        range.min                               = std::min(range.min, level.min[index]);
+        range.max                               = std::max(range.max, level.max[index]);
+    };
+
+    // climb while the start of the range is aligned on larger blocks which still fit, then go
+    // back down for the end of the range
+    std::size_t depth = 0; // raw samples
+    std::size_t span  = 1;
+    while (first < last)
+    {
+        if (first % (span * 2) == 0 && first + span * 2 <= last && depth < series.levels.size())
+        {
+            ++depth;
+            span *= 2;
+        }
+        else if (first + span <= last)
+        {
+            addBlock(depth, first / span);
+            first += span;
+        }
+        else
+        {
+            break;
+        }
+    }
+    while (first < last)
+    {
+        if (first + span <= last)
+        {
+            addBlock(depth, first / span);
+            first += span;
+        }
+        else
+        {
+            --depth;
+            span /= 2;
+        }
+    }
+    return range;
+}
+
+[[nodiscard]] TextureData getSpriteTextureData(const sf::Sprite& sprite)
 {
     const sf::Texture&  texture(sprite.getTexture());
     const sf::Vector2f  textureSize(texture.getSize());
     const sf::FloatRect textureRect(sprite.getTextureRect());
 
-    return {toImVec2(textureRect.position.componentWiseDiv(textureSize)),
-            toImVec2((textureRect.position + textureRect.size).componentWiseDiv(textureSize)),
-            convertGLTextureHandleToImTextureID(texture.getNativeHandle())};
+    return getTextureData(texture,
+                          toImVec2(textureRect.position.componentWiseDiv(textureSize)),
+                          toImVec2((textureRect.position + textureRect.size).componentWiseDiv(textureSize)));
 }
 
 void RenderDrawLists(ImDrawData* draw_data); // rendering callback function prototype
 
+// Draw data upload strategy of the shader renderer, which falls back to orphaning if the requested
+// one isn't supported. The fixed-function renderer only ever draws from client memory.
+struct BufferUploadState
+{
+    ImGui::SFML::BufferUploadStrategy requested{ImGui::SFML::BufferUploadStrategy::Orphan};
+#ifdef IMGUI_SFML_SHADER_RENDERER
+    ImGui::SFML::BufferUploadStrategy effective{ImGui::SFML::BufferUploadStrategy::Orphan};
+#else
+    ImGui::SFML::BufferUploadStrategy effective{ImGui::SFML::BufferUploadStrategy::ClientMemory};
+#endif
+};
+
+BufferUploadState s_bufferUpload;
+
+std::optional<ImGui::SFML::GeometryCacheSettings> s_geometryCacheSettings; // disabled if empty
+ImGui::SFML::GeometryCacheStats                   s_geometryCacheStats;
+#ifdef IMGUI_SFML_SHADER_RENDERER
+[[nodiscard]] bool isShaderRendererSupported();
+[[nodiscard]] bool hasDistanceFieldProgram();
+void               clearGeometryCache();
+void               destroyShaderRenderer();
+#endif
+
 // Default mapping is XInput gamepad mapping
 void initDefaultJoystickMapping();
 
@@ -200,6 +552,8 @@ void updateJoystickDPadState(ImGuiIO& io);
 void updateJoystickAxisState(ImGuiIO& io);
 
 // clipboard functions
+// The text returned to ImGui is kept between calls; only the sf::String passed to or returned by
+// sf::Clipboard is allocated.
 void setClipboardText(ImGuiContext* /*ctx*/, const char* text)
 {
     sf::Clipboard::setString(sf::String::fromUtf8(text, text + std::strlen(text)));
@@ -209,8 +563,9 @@ void setClipboardText(ImGuiContext* /*ctx*/, const char* text)
 {
     static std::string s_clipboardText;
 
-    auto tmp = sf::Clipboard::getString().toUtf8();
-    s_clipboardText.assign(tmp.begin(), tmp.end());
+    const sf::String clipboard = sf::Clipboard::getString();
+    s_clipboardText.clear();
+    sf::Utf32::toUtf8(clipboard.begin(), clipboard.end(), std::back_inserter(s_clipboardText));
     return s_clipboardText.c_str();
 }
 
@@ -238,658 +593,4762 @@ struct TriggerInfo
     float              threshold{0};
 };
 
-struct WindowContext
+// GL_TIME_ELAPSED queries wrapped around RenderDrawLists. Queries are used in a ring and
+// results are only read once available, so GPU time lags a few frames but never stalls.
+struct GpuTimer
 {
-    const sf::Window* window;
-    ImGuiContext*     imContext{ImGui::CreateContext()};
+    static constexpr unsigned int QueryCount = 4;
 
-    std::optional<sf::Texture> fontTexture; // internal font atlas which is used if user doesn't set
-                                            // a custom sf::Texture.
+    bool enabled{false};
+    bool initialized{false};
 
-    bool             windowHasFocus;
-    bool             mouseMoved{false};
-    bool             mousePressed[3] = {false};
-    ImGuiMouseCursor lastCursor{ImGuiMouseCursor_COUNT};
+    GLuint        queries[QueryCount]     = {0};
+    std::uint64_t contextId{0}; // query objects aren't shared between GL contexts
+    bool          pending[QueryCount]     = {false};
+    std::uint64_t issuedFrame[QueryCount] = {0};
+    std::uint64_t nextFrame{0};
+    std::uint64_t lastReadFrame{0};
 
-    bool         touchDown[3] = {false};
-    sf::Vector2i touchPos;
+    std::optional<sf::Time> lastResult;
+};
 
-    unsigned int joystickId{getConnectedJoystickId()};
-    ImGuiKey     joystickMapping[sf::Joystick::ButtonCount] = {ImGuiKey_None};
-    StickInfo    dPadInfo;
-    StickInfo    lStickInfo;
-    StickInfo    rStickInfo;
-    TriggerInfo  lTriggerInfo;
-    TriggerInfo  rTriggerInfo;
+[[nodiscard]] bool beginGpuTimer(GpuTimer& timer);
+void               endGpuTimer(GpuTimer& timer);
+void               releaseGpuTimer(GpuTimer& timer);
 
-    std::optional<sf::Cursor> mouseCursors[ImGuiMouseCursor_COUNT];
+// sf::Drawable submitted with DrawDrawable, drawn by a draw list callback during rendering
+struct DrawableCommand
+{
+    const sf::Drawable* drawable;
+    sf::RenderStates    states;
+    sf::View            view;
+    sf::FloatRect       rect; // in ImGui display coordinates
+};
 
-#ifdef ANDROID
-#ifdef USE_JNI
-    bool wantTextInput{false};
-#endif
-#endif
+// Instances submitted by a DrawPrimitiveInstances call, drawn by a draw list callback. The draw
+// data isn't passed to callbacks, so the batch keeps the mapping of its viewport to the framebuffer.
+struct PrimitiveBatch
+{
+    std::size_t first; // in WindowContext::primitiveInstances
+    std::size_t count;
+    ImVec2      displayPos;
+    ImVec2      displaySize;
+    ImVec2      framebufferScale;
+};
+
+struct ContextAllocator;
+
+// Address ranges of the chunks and large blocks of every context allocator. Blocks are matched with
+// their allocator by address, so that nothing is read in front of blocks which came from another
+// allocator, e.g. the ones allocated before our functions were installed.
+struct AllocatorRange
+{
+    std::size_t       size;
+    ContextAllocator* owner;
+};
+
+std::map<std::uintptr_t, AllocatorRange> s_allocatorRanges;
+
+// Pool allocator for the allocations of an ImGui context. Small blocks are carved from chunks
+// owned by the allocator and recycled through per-size free lists, larger ones come from malloc.
+struct ContextAllocator
+{
+    static constexpr std::size_t MinBlockSize = 32;
+    static constexpr std::size_t ClassCount   = 8; // 32 to 4096 bytes
+    static constexpr std::size_t ChunkSize    = 64 * 1024;
 
-    WindowContext(const sf::Window* w) : window(w), windowHasFocus(window->hasFocus())
+    struct FreeBlock
     {
-    }
-    ~WindowContext()
+        FreeBlock* next;
+    };
+
+    std::vector<std::unique_ptr<std::byte[]>> chunks;
+    std::size_t                               chunkUsed{ChunkSize};
+    FreeBlock*                                freeLists[ClassCount] = {nullptr};
+
+    ImGui::SFML::AllocatorStats stats;
+    std::size_t                 allocationsThisFrame{0};
+    bool                        retired{false}; // its context is gone, but some of its blocks are still live
+
+    ContextAllocator() = default;
+    ~ContextAllocator()
     {
-        ImGui::DestroyContext(imContext);
+        for (const std::unique_ptr<std::byte[]>& chunk : chunks)
+            s_allocatorRanges.erase(reinterpret_cast<std::uintptr_t>(chunk.get()));
     }
 
-    WindowContext(const WindowContext&)            = delete; // non construction-copyable
-    WindowContext& operator=(const WindowContext&) = delete; // non copyable
+    ContextAllocator(const ContextAllocator&)            = delete;
+    ContextAllocator& operator=(const ContextAllocator&) = delete;
 };
 
-std::vector<std::unique_ptr<WindowContext>> s_windowContexts;
-WindowContext*                              s_currWindowCtx = nullptr;
+// every block of a context allocator starts with a header, so that it can be freed whichever context is current
+struct alignas(std::max_align_t) AllocationHeader
+{
+    std::size_t size;
+};
 
-} // end of anonymous namespace
+ContextAllocator* s_activeAllocator = nullptr; // receives the allocations of the current ImGui context
 
-namespace ImGui
-{
-namespace SFML
+// allocators of destroyed contexts, kept until ImVector memory which outlived them is freed
+std::vector<std::unique_ptr<ContextAllocator>> s_retiredAllocators;
+
+bool              s_allocatorFunctionsInstalled = false;
+ImGuiMemAllocFunc s_fallbackAllocFunc           = nullptr;
+ImGuiMemFreeFunc  s_fallbackFreeFunc            = nullptr;
+void*             s_fallbackAllocUserData       = nullptr;
+
+[[nodiscard]] std::optional<std::size_t> getAllocatorSizeClass(std::size_t blockSize)
 {
-bool Init(sf::RenderWindow& window, bool loadDefaultFont)
+    std::size_t sizeClass = 0;
+    for (std::size_t classSize = ContextAllocator::MinBlockSize; classSize < blockSize; classSize *= 2)
+    {
+        if (++sizeClass == ContextAllocator::ClassCount)
+            return std::nullopt;
+    }
+    return sizeClass;
+}
+
+[[nodiscard]] void* allocateBlock(ContextAllocator& allocator, std::size_t blockSize)
 {
-    return Init(window, window, loadDefaultFont);
+    const std::optional<std::size_t> sizeClass = getAllocatorSizeClass(blockSize);
+    if (!sizeClass)
+    {
+        void* block = std::malloc(blockSize);
+        if (block)
+        {
+            allocator.stats.reservedBytes += blockSize;
+            s_allocatorRanges.emplace(reinterpret_cast<std::uintptr_t>(block), AllocatorRange{blockSize, &allocator});
+        }
+        return block;
+    }
+
+    if (ContextAllocator::FreeBlock* block = allocator.freeLists[*sizeClass])
+    {
+        allocator.freeLists[*sizeClass] = block->next;
+        return block;
+    }
+
+    const std::size_t classSize = ContextAllocator::MinBlockSize << *sizeClass;
+    if (allocator.chunkUsed + classSize > ContextAllocator::ChunkSize)
+    {
+        allocator.chunks.push_back(std::make_unique<std::byte[]>(ContextAllocator::ChunkSize));
+        allocator.chunkUsed = 0;
+        allocator.stats.reservedBytes += ContextAllocator::ChunkSize;
+        s_allocatorRanges.emplace(reinterpret_cast<std::uintptr_t>(allocator.chunks.back().get()),
+                                  AllocatorRange{ContextAllocator::ChunkSize, &allocator});
+    }
+
+    void* block = allocator.chunks.back().get() + allocator.chunkUsed;
+    allocator.chunkUsed += classSize;
+    return block;
 }
 
-bool Init(sf::Window& window, sf::RenderTarget& target, bool loadDefaultFont)
+void freeBlock(ContextAllocator& allocator, void* block, std::size_t blockSize)
 {
-    return Init(window, sf::Vector2f(target.getSize()), loadDefaultFont);
+    const std::optional<std::size_t> sizeClass = getAllocatorSizeClass(blockSize);
+    if (!sizeClass)
+    {
+        allocator.stats.reservedBytes -= blockSize;
+        s_allocatorRanges.erase(reinterpret_cast<std::uintptr_t>(block));
+        std::free(block);
+        return;
+    }
+
+    allocator.freeLists[*sizeClass] = new (block) ContextAllocator::FreeBlock{allocator.freeLists[*sizeClass]};
 }
 
-bool Init(sf::Window& window, const sf::Vector2f& displaySize, bool loadDefaultFont)
+[[nodiscard]] ContextAllocator* findBlockOwner(const void* ptr)
 {
-    s_currWindowCtx = s_windowContexts.emplace_back(std::make_unique<WindowContext>(&window)).get();
-    ImGui::SetCurrentContext(s_currWindowCtx->imContext);
+    const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+    auto       found   = s_allocatorRanges.upper_bound(address);
+    if (found == s_allocatorRanges.begin())
+        return nullptr;
 
-    ImGuiIO&         io          = ImGui::GetIO();
-    ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
+    --found;
+    return address < found->first + found->second.size ? found->second.owner : nullptr;
+}
 
-    // tell ImGui which features we support
-    io.BackendFlags |= ImGuiBackendFlags_HasGamepad;
-    io.BackendFlags |= ImGuiBackendFlags_HasMouseCursors;
-    io.BackendFlags |= ImGuiBackendFlags_HasSetMousePos;
-    io.BackendPlatformName = "imgui_impl_sfml";
+void* allocateImGuiMemory(std::size_t size, void* /*userData*/)
+{
+    ContextAllocator* const owner = s_activeAllocator;
+    if (!owner)
+        return s_fallbackAllocFunc(size, s_fallbackAllocUserData);
 
-    s_currWindowCtx->joystickId = getConnectedJoystickId();
+    void* block = allocateBlock(*owner, sizeof(AllocationHeader) + size);
+    if (!block)
+        return nullptr;
 
-    initDefaultJoystickMapping();
+    ImGui::SFML::AllocatorStats& stats = owner->stats;
+    stats.liveBytes += size;
+    stats.peakBytes = std::max(stats.peakBytes, stats.liveBytes);
+    ++stats.totalAllocations;
+    ++owner->allocationsThisFrame;
 
-    // init rendering
-    io.DisplaySize = toImVec2(displaySize);
+    return new (block) AllocationHeader{size} + 1;
+}
 
-    // clipboard
-    platform_io.Platform_SetClipboardTextFn = setClipboardText;
-    platform_io.Platform_GetClipboardTextFn = getClipboardText;
+void freeImGuiMemory(void* ptr, void* /*userData*/)
+{
+    if (!ptr)
+        return;
+
+    ContextAllocator* const owner = findBlockOwner(ptr);
+    if (!owner)
+    {
+        s_fallbackFreeFunc(ptr, s_fallbackAllocUserData);
+        return;
+    }
 
-    // load mouse cursors
-    const auto loadMouseCursor = [](ImGuiMouseCursor imguiCursorType, sf::Cursor::Type sfmlCursorType)
-    { s_currWindowCtx->mouseCursors[imguiCursorType] = sf::Cursor::createFromSystem(sfmlCursorType); };
-    loadMouseCursor(ImGuiMouseCursor_Arrow, sf::Cursor::Type::Arrow);
-    loadMouseCursor(ImGuiMouseCursor_TextInput, sf::Cursor::Type::Text);
-    loadMouseCursor(ImGuiMouseCursor_ResizeAll, sf::Cursor::Type::SizeAll);
-    loadMouseCursor(ImGuiMouseCursor_ResizeNS, sf::Cursor::Type::SizeVertical);
-    loadMouseCursor(ImGuiMouseCursor_ResizeEW, sf::Cursor::Type::SizeHorizontal);
-    loadMouseCursor(ImGuiMouseCursor_ResizeNESW, sf::Cursor::Type::SizeBottomLeftTopRight);
-    loadMouseCursor(ImGuiMouseCursor_ResizeNWSE, sf::Cursor::Type::SizeTopLeftBottomRight);
-    loadMouseCursor(ImGuiMouseCursor_Hand, sf::Cursor::Type::Hand);
+    AllocationHeader* const header = static_cast<AllocationHeader*>(ptr) - 1;
+    owner->stats.liveBytes -= header->size;
+    freeBlock(*owner, header, sizeof(AllocationHeader) + header->size);
 
-    if (loadDefaultFont)
+    if (owner->retired && owner->stats.liveBytes == 0)
     {
-        // this will load default font automatically
-        // No need to call AddDefaultFont
-        return UpdateFontTexture();
+        s_retiredAllocators.erase(std::find_if(s_retiredAllocators.begin(),
+                                               s_retiredAllocators.end(),
+                                               [owner](const std::unique_ptr<ContextAllocator>& retired)
+                                               { return retired.get() == owner; }));
     }
+}
 
-    return true;
+// Blocks allocated before the installation come from the previous functions and are freed through
+// them, since they don't belong to any context allocator
+void installAllocatorFunctions()
+{
+    if (s_allocatorFunctionsInstalled)
+        return;
+
+    ImGui::GetAllocatorFunctions(&s_fallbackAllocFunc, &s_fallbackFreeFunc, &s_fallbackAllocUserData);
+    ImGui::SetAllocatorFunctions(allocateImGuiMemory, freeImGuiMemory);
+    s_allocatorFunctionsInstalled = true;
 }
 
-void SetCurrentWindow(const sf::Window& window)
+[[nodiscard]] ImGuiContext* createImGuiContext(ContextAllocator* allocator)
 {
-    auto found = std::find_if(s_windowContexts.begin(),
-                              s_windowContexts.end(),
-                              [&](std::unique_ptr<WindowContext>& ctx)
-                              { return ctx->window->getNativeHandle() == window.getNativeHandle(); });
-    assert(found != s_windowContexts.end() &&
-           "Failed to find the window. Forgot to call ImGui::SFML::Init for the window?");
-    s_currWindowCtx = found->get();
-    ImGui::SetCurrentContext(s_currWindowCtx->imContext);
+    ContextAllocator* const previous = std::exchange(s_activeAllocator, allocator);
+    ImGuiContext* const     context  = ImGui::CreateContext();
+    s_activeAllocator                = previous;
+    return context;
 }
 
-void ProcessEvent(const sf::Window& window, const sf::Event& event)
+// System cursors shared by all windows, loaded on first use and released along with the last window
+struct CursorCache
 {
-    SetCurrentWindow(window);
-    assert(s_currWindowCtx && "No current window is set - forgot to call ImGui::SFML::Init?");
-    ImGuiIO& io = ImGui::GetIO();
+    std::optional<sf::Cursor> cursors[ImGuiMouseCursor_COUNT];
+    bool                      loadAttempted[ImGuiMouseCursor_COUNT] = {false};
+    std::size_t               refCount{0};
+};
 
-    if (s_currWindowCtx->windowHasFocus)
+CursorCache s_cursorCache;
+
+// State of the low-latency mode. Times are relative to s_pacingClock.
+struct FramePacer
+{
+    std::optional<ImGui::SFML::LowLatencySettings> settings; // disabled if empty
+
+    std::optional<sf::Time> lastPresent;
+    sf::Time                framePeriod;  // smoothed interval between presents
+    sf::Time                workEstimate; // from waking up to the end of rendering, decaying peak
+    std::optional<sf::Time> wakeTime;
+    std::optional<sf::Time> sampleTime; // when Update sampled the mouse
+    std::optional<sf::Time> renderEnd;
+
+    std::optional<sf::Time> lastLatency;
+    sf::Time                latencyEstimate; // smoothed, used as the cursor prediction horizon
+
+    std::optional<sf::Vector2f> lastMousePos;
+    sf::Time                    lastMouseTime;
+    sf::Vector2f                mouseVelocity; // pixels per second
+};
+
+sf::Clock s_pacingClock;
+
+// DPI scaling: the fonts are baked again for every framebuffer scale the window is displayed at
+struct FontAtlasDeleter
+{
+    void operator()(ImFontAtlas* atlas) const
     {
-        if (const auto* resized = event.getIf<sf::Event::Resized>())
-        {
-            io.DisplaySize = toImVec2(sf::Vector2f(resized->size));
-        }
-        else if (const auto* mouseMoved = event.getIf<sf::Event::MouseMoved>())
-        {
-            const auto [x, y] = sf::Vector2f(mouseMoved->position);
-            io.AddMousePosEvent(x, y);
-            s_currWindowCtx->mouseMoved = true;
-        }
-        else if (const auto* mouseButtonPressed = event.getIf<sf::Event::MouseButtonPressed>())
-        {
-            const int button = static_cast<int>(mouseButtonPressed->button);
-            if (button >= 0 && button < 3)
-            {
-                s_currWindowCtx->mousePressed[static_cast<int>(mouseButtonPressed->button)] = true;
-                io.AddMouseButtonEvent(button, true);
-            }
+        IM_DELETE(atlas);
+    }
+};
+
+struct ScaledFontAtlas
+{
+    float                                          scale{1.f};
+    std::unique_ptr<ImFontAtlas, FontAtlasDeleter> atlas;
+    sf::Texture                                    texture;
+    std::uint64_t                                  lastUsedFrame{0};
+};
+
+struct DpiState
+{
+    std::optional<ImGui::SFML::DpiSettings> settings; // disabled if empty
+
+    ImFontAtlas*                 baseAtlas{nullptr}; // the context's own atlas, baked at scale 1
+    float                        currentScale{1.f};
+    float                        contentScale{1.f}; // of the window's monitor, set by the application
+    std::vector<ScaledFontAtlas> atlases;           // least recently used ones are evicted
+};
+
+// Window coordinates are divided by this to get the layout's
+[[nodiscard]] float layoutScale(const DpiState& dpi)
+{
+    return dpi.settings ? dpi.contentScale : 1.f;
+}
+
+// Signed distance field fonts: the atlas stores distances to the glyphs' outlines, which a
+// fragment shader turns back into coverage at whatever scale the text is drawn
+struct SdfFontState
+{
+    ImGui::SFML::SdfFontSettings settings;
+#ifndef IMGUI_SFML_SHADER_RENDERER
+    sf::Shader shader; // the shader renderer has its own distance field program
+#endif
+
+    // restored when the mode is disabled
+    int              previousGlyphPadding{1};
+    ImFontAtlasFlags previousFlags{0};
+};
+
+#ifndef IMGUI_SFML_SHADER_RENDERER
+constexpr const char* sdfVertexShader = R"(
+void main()
+{
+    gl_Position    = gl_ModelViewProjectionMatrix * gl_Vertex;
+    gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;
+    gl_FrontColor  = gl_Color;
+}
+)";
+
+constexpr const char* sdfFragmentShader = R"(
+uniform sampler2D texture;
+
+void main()
+{
+    float field    = texture2D(texture, gl_TexCoord[0].xy).a;
+    float width    = max(fwidth(field), 0.0001);
+    float coverage = smoothstep(0.5 - width, 0.5 + width, field);
+    gl_FragColor   = vec4(gl_Color.rgb, gl_Color.a * coverage);
+}
+)";
+#endif
+
+// Peak buffer use of a rendered draw list since its buffers were last checked by TrimMemory
+struct DrawListUsage
+{
+    int           peakVtxCount{0};
+    int           peakIdxCount{0};
+    int           peakCmdCount{0};
+    std::uint64_t sinceFrame{0};
+    std::uint64_t lastSeenFrame{0};
+};
+
+struct WindowContext
+{
+    const sf::Window* window;
+
+    // declared before the ImGui context, which is destroyed first
+    std::unique_ptr<ContextAllocator> allocator;
+    ImGuiContext*                     imContext{createImGuiContext(allocator.get())};
+
+    std::optional<sf::Texture> fontTexture; // internal font atlas which is used if user doesn't set
+                                            // a custom sf::Texture.
+
+    bool             windowHasFocus;
+    bool             mouseMoved{false};
+    bool             mousePressed[3] = {false};
+    ImGuiMouseCursor lastCursor{ImGuiMouseCursor_COUNT};
+
+    bool         touchDown[3] = {false};
+    sf::Vector2i touchPos;
+
+    unsigned int joystickId{getConnectedJoystickId()};
+    ImGuiKey     joystickMapping[sf::Joystick::ButtonCount] = {ImGuiKey_None};
+    StickInfo    dPadInfo;
+    StickInfo    lStickInfo;
+    StickInfo    rStickInfo;
+    TriggerInfo  lTriggerInfo;
+    TriggerInfo  rTriggerInfo;
+
+    // query objects belong to the GL context the window was rendered with
+    GpuTimer gpuTimer;
+
+    // referenced by index from draw list callbacks, cleared when a new frame starts. Instance
+    // rects are in ImGui display coordinates.
+    std::vector<DrawableCommand>         drawableCommands;
+    std::vector<PrimitiveBatch>          primitiveBatches;
+    std::vector<ImGui::PrimitiveInstance> primitiveInstances;
+
+    // keys are only compared, draw lists which weren't seen for a while may be dangling
+    std::unordered_map<const ImDrawList*, DrawListUsage> drawListUsage;
+
+    // ProcessEvent calls are traced as a single batch which ends when the next frame starts
+    std::optional<sf::Time> eventBatchBegin;
+    sf::Time                eventBatchEnd;
+
+    FramePacer pacer;
+    DpiState   dpi;
+
+    std::optional<SdfFontState> sdf; // disabled if empty
+
+    std::ostream* inputRecording{nullptr};
+    bool          replaying{false}; // devices aren't polled, the mouse buttons come from the recording
+    std::uint8_t  replayMouseDown{0};
+
+#ifdef ANDROID
+#ifdef USE_JNI
+    bool wantTextInput{false};
+#endif
+#endif
+
+    WindowContext(const sf::Window* w, bool useContextAllocator) :
+    window(w),
+    allocator(useContextAllocator ? std::make_unique<ContextAllocator>() : nullptr),
+    windowHasFocus(window->hasFocus())
+    {
+        ++s_cursorCache.refCount;
+    }
+    ~WindowContext()
+    {
+        if (--s_cursorCache.refCount == 0)
+            s_cursorCache = CursorCache{};
+
+        // the context deletes the atlas io.Fonts points to
+        if (dpi.baseAtlas)
+        {
+            ImGuiContext* const previous = ImGui::GetCurrentContext();
+            ImGui::SetCurrentContext(imContext);
+            ImGui::GetIO().Fonts = dpi.baseAtlas;
+            ImGui::SetCurrentContext(previous);
         }
-        else if (const auto* mouseButtonReleased = event.getIf<sf::Event::MouseButtonReleased>())
+
+        ContextAllocator* const previous = std::exchange(s_activeAllocator, allocator.get());
+        ImGui::DestroyContext(imContext);
+        s_activeAllocator = previous == allocator.get() ? nullptr : previous;
+
+        // ImVector memory which outlives the context is still freed through its allocator
+        if (allocator && allocator->stats.liveBytes > 0)
+        {
+            allocator->retired = true;
+            s_retiredAllocators.push_back(std::move(allocator));
+        }
+    }
+
+    WindowContext(const WindowContext&)            = delete; // non construction-copyable
+    WindowContext& operator=(const WindowContext&) = delete; // non copyable
+};
+
+std::vector<std::unique_ptr<WindowContext>> s_windowContexts;
+WindowContext*                              s_currWindowCtx = nullptr;
+
+void setCurrentWindowContext(WindowContext* ctx)
+{
+    s_currWindowCtx   = ctx;
+    s_activeAllocator = ctx ? ctx->allocator.get() : nullptr;
+    ImGui::SetCurrentContext(ctx ? ctx->imContext : nullptr);
+}
+
+// contexts of closed windows, kept for reuse by Init
+std::vector<std::unique_ptr<WindowContext>> s_contextPool;
+std::size_t                                 s_maxPooledContexts = 0;
+
+// Deletes the queries of the window's GPU timer. Their context is activated if needed, they went
+// away along with it if the window was closed already.
+void releaseWindowGpuTimer(WindowContext& ctx)
+{
+    if (ctx.gpuTimer.initialized && sf::Context::getActiveContextId() != ctx.gpuTimer.contextId && ctx.window &&
+        ctx.window->isOpen())
+    {
+        (void)ctx.window->setActive(true);
+    }
+    releaseGpuTimer(ctx.gpuTimer);
+}
+
+// Resets the state which belongs to the window, keeping the ImGui context, font texture and joystick mapping
+void rebindWindowContext(WindowContext& ctx, const sf::Window* window)
+{
+    releaseWindowGpuTimer(ctx); // queries belong to the previous window's GL context
+
+    ctx.window         = window;
+    ctx.windowHasFocus = window && window->hasFocus();
+    ctx.mouseMoved     = false;
+    ctx.lastCursor     = ImGuiMouseCursor_COUNT;
+    ctx.touchPos       = sf::Vector2i();
+    std::fill(std::begin(ctx.mousePressed), std::end(ctx.mousePressed), false);
+    std::fill(std::begin(ctx.touchDown), std::end(ctx.touchDown), false);
+
+    ctx.joystickId = getConnectedJoystickId();
+    ctx.drawableCommands.clear();
+    ctx.primitiveBatches.clear();
+    ctx.primitiveInstances.clear();
+    ctx.drawListUsage.clear();
+    ctx.eventBatchBegin.reset();
+    ctx.pacer          = FramePacer{};
+    ctx.inputRecording = nullptr;
+
+#ifdef ANDROID
+#ifdef USE_JNI
+    ctx.wantTextInput = false;
+#endif
+#endif
+}
+
+[[nodiscard]] std::unique_ptr<WindowContext> takePooledContext(const sf::Window& window, bool useContextAllocator)
+{
+    const auto found = std::find_if(s_contextPool.rbegin(),
+                                    s_contextPool.rend(),
+                                    [&](const std::unique_ptr<WindowContext>& ctx)
+                                    { return (ctx->allocator != nullptr) == useContextAllocator; });
+    if (found == s_contextPool.rend())
+        return nullptr;
+
+    std::unique_ptr<WindowContext> ctx = std::move(*found);
+    s_contextPool.erase(std::next(found).base());
+    rebindWindowContext(*ctx, &window);
+    return ctx;
+}
+
+void trackDrawListUsage(WindowContext& ctx, const ImDrawList& drawList);
+
+template <typename T>
+[[nodiscard]] std::size_t getCapacityBytes(const ImVector<T>& vector)
+{
+    return static_cast<std::size_t>(vector.Capacity) * sizeof(T);
+}
+
+template <typename T>
+[[nodiscard]] std::size_t getCapacityBytes(const std::vector<T>& vector)
+{
+    return vector.capacity() * sizeof(T);
+}
+
+// Reallocates the buffer to fit its peak size if its capacity is more than slack times larger
+template <typename T>
+void shrinkImVector(ImVector<T>& vector, int peakSize, float slack)
+{
+    const int targetCapacity = std::max(peakSize, vector.Size);
+    if (static_cast<float>(vector.Capacity) <= static_cast<float>(std::max(targetCapacity, 1)) * slack)
+        return;
+
+    ImVector<T> shrunk;
+    shrunk.reserve(targetCapacity);
+    shrunk.resize(vector.Size);
+    if (vector.Size > 0)
+        std::memcpy(shrunk.Data, vector.Data, static_cast<std::size_t>(vector.Size) * sizeof(T));
+    vector.swap(shrunk);
+}
+
+sf::RenderTarget* s_currRenderTarget = nullptr; // set while rendering with Render(target)
+
+std::uint64_t s_frameCounter = 0; // incremented on every Update
+
+// Resources used within the last frame of every window may still be referenced by draw lists
+// which haven't been rendered yet, so they can't be reused or released
+[[nodiscard]] bool mayBeInFlight(std::uint64_t lastUsedFrame)
+{
+    return lastUsedFrame + s_windowContexts.size() >= s_frameCounter;
+}
+
+void drawDrawableCallback(const ImDrawList* parentList, const ImDrawCmd* cmd);
+#ifdef IMGUI_SFML_RENDERER_GLES3
+void drawPrimitivesCallback(const ImDrawList* parentList, const ImDrawCmd* cmd);
+#endif
+
+// tracing
+[[nodiscard]] std::uint64_t windowHandleToTraceId(sf::WindowHandle handle)
+{
+    if constexpr (std::is_pointer_v<sf::WindowHandle>)
+        return reinterpret_cast<std::uintptr_t>(handle);
+    else
+        return static_cast<std::uint64_t>(handle);
+}
+
+// The event is stored as relaxed atomic words, so that a reader racing with the writer gets torn
+// values (and discards them) instead of a data race
+struct TraceSlot
+{
+    // odd while the event is being written, 2 * (index + 1) once it's complete
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<int>           phase{0};
+    std::atomic<std::uint64_t> windowId{0};
+    std::atomic<std::int64_t>  begin{0}; // microseconds
+    std::atomic<std::int64_t>  end{0};
+};
+
+struct TraceState
+{
+    static constexpr std::uint64_t Capacity = 8192;
+
+    std::atomic<bool>            enabled{false};
+    std::unique_ptr<TraceSlot[]> slots; // allocated when tracing is first enabled
+    std::atomic<std::uint64_t>   writeIndex{0};
+    std::uint64_t                readIndex{0};
+
+    ImGui::SFML::TraceSink sink{nullptr};
+    void*                  sinkUserData{nullptr};
+
+    sf::Clock clock;
+};
+
+TraceState s_tracing;
+
+[[nodiscard]] sf::WindowHandle getCurrentWindowHandle()
+{
+    return s_currWindowCtx ? s_currWindowCtx->window->getNativeHandle() : sf::WindowHandle{};
+}
+
+// single producer: all backend calls are made from the thread owning the windows
+void recordTraceEvent(const ImGui::SFML::TraceEvent& event)
+{
+    const std::uint64_t index = s_tracing.writeIndex.load(std::memory_order_relaxed);
+    TraceSlot&          slot  = s_tracing.slots[index % TraceState::Capacity];
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.phase.store(static_cast<int>(event.phase), std::memory_order_relaxed);
+    slot.windowId.store(windowHandleToTraceId(event.window), std::memory_order_relaxed);
+    slot.begin.store(event.begin.asMicroseconds(), std::memory_order_relaxed);
+    slot.end.store(event.end.asMicroseconds(), std::memory_order_relaxed);
+    slot.sequence.store(2 * (index + 1), std::memory_order_release);
+    s_tracing.writeIndex.store(index + 1, std::memory_order_release);
+
+    if (s_tracing.sink)
+        s_tracing.sink(event, s_tracing.sinkUserData);
+}
+
+struct TraceScope
+{
+    explicit TraceScope(ImGui::SFML::TracePhase p) : phase(p)
+    {
+    }
+    ~TraceScope()
+    {
+        if (active)
+            recordTraceEvent({phase, getCurrentWindowHandle(), begin, s_tracing.clock.getElapsedTime()});
+    }
+
+    TraceScope(const TraceScope&)            = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    ImGui::SFML::TracePhase phase;
+    bool                    active{s_tracing.enabled.load(std::memory_order_acquire)};
+    sf::Time                begin{active ? s_tracing.clock.getElapsedTime() : sf::Time::Zero};
+};
+
+void flushEventBatchTrace(WindowContext& ctx)
+{
+    if (!ctx.eventBatchBegin)
+        return;
+
+    if (s_tracing.enabled.load(std::memory_order_acquire))
+    {
+        recordTraceEvent(
+            {ImGui::SFML::TracePhase::ProcessEvents, ctx.window->getNativeHandle(), *ctx.eventBatchBegin, ctx.eventBatchEnd});
+    }
+    ctx.eventBatchBegin.reset();
+}
+
+// input recording
+// A recording starts with a header, followed by event and update records. Values are little endian.
+constexpr char         InputRecordingMagic[4] = {'I', 'S', 'F', 'R'};
+constexpr std::uint8_t InputRecordingVersion  = 2;
+
+enum class InputRecordType : std::uint8_t
+{
+    Event  = 1,
+    Update = 2
+};
+
+// only the events handled by ProcessEvent are recorded
+enum class RecordedEventType : std::uint8_t
+{
+    Resized,
+    FocusLost,
+    FocusGained,
+    TextEntered,
+    KeyPressed,
+    KeyReleased,
+    MouseWheelScrolled,
+    MouseButtonPressed,
+    MouseButtonReleased,
+    MouseMoved,
+    TouchBegan,
+    TouchEnded,
+    JoystickConnected,
+    JoystickDisconnected
+};
+
+template <typename T>
+void writeLE(std::ostream& out, T value)
+{
+    static_assert(std::is_unsigned_v<T>);
+    char bytes[sizeof(T)];
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    out.write(bytes, sizeof(T));
+}
+
+template <typename T>
+[[nodiscard]] bool readLE(std::istream& in, T& value)
+{
+    static_assert(std::is_unsigned_v<T>);
+    unsigned char bytes[sizeof(T)];
+    if (!in.read(reinterpret_cast<char*>(bytes), sizeof(T)))
+        return false;
+
+    value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        value = static_cast<T>(value | static_cast<T>(T{bytes[i]} << (8 * i)));
+    return true;
+}
+
+void writeI32(std::ostream& out, std::int32_t value)
+{
+    writeLE(out, static_cast<std::uint32_t>(value));
+}
+
+[[nodiscard]] bool readI32(std::istream& in, std::int32_t& value)
+{
+    std::uint32_t bits = 0;
+    if (!readLE(in, bits))
+        return false;
+    value = static_cast<std::int32_t>(bits);
+    return true;
+}
+
+void writeF32(std::ostream& out, float value)
+{
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeLE(out, bits);
+}
+
+[[nodiscard]] bool readF32(std::istream& in, float& value)
+{
+    std::uint32_t bits = 0;
+    if (!readLE(in, bits))
+        return false;
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+void writeVector2i(std::ostream& out, sf::Vector2i vector)
+{
+    writeI32(out, vector.x);
+    writeI32(out, vector.y);
+}
+
+[[nodiscard]] bool readVector2i(std::istream& in, sf::Vector2i& vector)
+{
+    return readI32(in, vector.x) && readI32(in, vector.y);
+}
+
+void writeRecordedEvent(std::ostream& out, const sf::Event& event)
+{
+    const auto writeHeader = [&out](RecordedEventType type)
+    {
+        writeLE(out, static_cast<std::uint8_t>(InputRecordType::Event));
+        writeLE(out, static_cast<std::uint8_t>(type));
+    };
+    const auto writeKey = [&out, &writeHeader](RecordedEventType type, const auto& key)
+    {
+        writeHeader(type);
+        writeI32(out, static_cast<std::int32_t>(key.code));
+        writeI32(out, static_cast<std::int32_t>(key.scancode));
+        writeLE(out, static_cast<std::uint8_t>(key.alt | key.control << 1 | key.shift << 2 | key.system << 3));
+    };
+    const auto writeMouseButton = [&out, &writeHeader](RecordedEventType type, const auto& mouseButton)
+    {
+        writeHeader(type);
+        writeI32(out, static_cast<std::int32_t>(mouseButton.button));
+        writeVector2i(out, mouseButton.position);
+    };
+    const auto writeTouch = [&out, &writeHeader](RecordedEventType type, const auto& touch)
+    {
+        writeHeader(type);
+        writeLE(out, static_cast<std::uint32_t>(touch.finger));
+        writeVector2i(out, touch.position);
+    };
+
+    if (const auto* resized = event.getIf<sf::Event::Resized>())
+    {
+        writeHeader(RecordedEventType::Resized);
+        writeLE(out, std::uint32_t{resized->size.x});
+        writeLE(out, std::uint32_t{resized->size.y});
+    }
+    else if (event.is<sf::Event::FocusLost>())
+        writeHeader(RecordedEventType::FocusLost);
+    else if (event.is<sf::Event::FocusGained>())
+        writeHeader(RecordedEventType::FocusGained);
+    else if (const auto* textEntered = event.getIf<sf::Event::TextEntered>())
+    {
+        writeHeader(RecordedEventType::TextEntered);
+        writeLE(out, static_cast<std::uint32_t>(textEntered->unicode));
+    }
+    else if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
+        writeKey(RecordedEventType::KeyPressed, *keyPressed);
+    else if (const auto* keyReleased = event.getIf<sf::Event::KeyReleased>())
+        writeKey(RecordedEventType::KeyReleased, *keyReleased);
+    else if (const auto* mouseWheelScrolled = event.getIf<sf::Event::MouseWheelScrolled>())
+    {
+        writeHeader(RecordedEventType::MouseWheelScrolled);
+        writeI32(out, static_cast<std::int32_t>(mouseWheelScrolled->wheel));
+        writeF32(out, mouseWheelScrolled->delta);
+        writeVector2i(out, mouseWheelScrolled->position);
+    }
+    else if (const auto* mouseButtonPressed = event.getIf<sf::Event::MouseButtonPressed>())
+        writeMouseButton(RecordedEventType::MouseButtonPressed, *mouseButtonPressed);
+    else if (const auto* mouseButtonReleased = event.getIf<sf::Event::MouseButtonReleased>())
+        writeMouseButton(RecordedEventType::MouseButtonReleased, *mouseButtonReleased);
+    else if (const auto* mouseMoved = event.getIf<sf::Event::MouseMoved>())
+    {
+        writeHeader(RecordedEventType::MouseMoved);
+        writeVector2i(out, mouseMoved->position);
+    }
+    else if (const auto* touchBegan = event.getIf<sf::Event::TouchBegan>())
+        writeTouch(RecordedEventType::TouchBegan, *touchBegan);
+    else if (const auto* touchEnded = event.getIf<sf::Event::TouchEnded>())
+        writeTouch(RecordedEventType::TouchEnded, *touchEnded);
+    else if (const auto* joystickConnected = event.getIf<sf::Event::JoystickConnected>())
+    {
+        writeHeader(RecordedEventType::JoystickConnected);
+        writeLE(out, static_cast<std::uint32_t>(joystickConnected->joystickId));
+    }
+    else if (const auto* joystickDisconnected = event.getIf<sf::Event::JoystickDisconnected>())
+    {
+        writeHeader(RecordedEventType::JoystickDisconnected);
+        writeLE(out, static_cast<std::uint32_t>(joystickDisconnected->joystickId));
+    }
+}
+
+// reads the payload of an event record
+[[nodiscard]] std::optional<sf::Event> readRecordedEvent(std::istream& in)
+{
+    std::uint8_t type = 0;
+    if (!readLE(in, type))
+        return std::nullopt;
+
+    const auto readKey = [&in](auto key) -> std::optional<sf::Event>
+    {
+        std::int32_t code      = 0;
+        std::int32_t scancode  = 0;
+        std::uint8_t modifiers = 0;
+        if (!readI32(in, code) || !readI32(in, scancode) || !readLE(in, modifiers))
+            return std::nullopt;
+        key.code     = static_cast<sf::Keyboard::Key>(code);
+        key.scancode = static_cast<sf::Keyboard::Scancode>(scancode);
+        key.alt      = (modifiers & 1) != 0;
+        key.control  = (modifiers & 2) != 0;
+        key.shift    = (modifiers & 4) != 0;
+        key.system   = (modifiers & 8) != 0;
+        return key;
+    };
+    const auto readMouseButton = [&in](auto mouseButton) -> std::optional<sf::Event>
+    {
+        std::int32_t button = 0;
+        if (!readI32(in, button) || !readVector2i(in, mouseButton.position))
+            return std::nullopt;
+        mouseButton.button = static_cast<sf::Mouse::Button>(button);
+        return mouseButton;
+    };
+    const auto readTouch = [&in](auto touch) -> std::optional<sf::Event>
+    {
+        std::uint32_t finger = 0;
+        if (!readLE(in, finger) || !readVector2i(in, touch.position))
+            return std::nullopt;
+        touch.finger = finger;
+        return touch;
+    };
+    const auto readJoystickId = [&in](auto joystick) -> std::optional<sf::Event>
+    {
+        std::uint32_t joystickId = 0;
+        if (!readLE(in, joystickId))
+            return std::nullopt;
+        joystick.joystickId = joystickId;
+        return joystick;
+    };
+
+    switch (static_cast<RecordedEventType>(type))
+    {
+        case RecordedEventType::Resized:
+        {
+            sf::Event::Resized resized;
+            if (!readLE(in, resized.size.x) || !readLE(in, resized.size.y))
+                return std::nullopt;
+            return resized;
+        }
+        case RecordedEventType::FocusLost:
+            return sf::Event::FocusLost{};
+        case RecordedEventType::FocusGained:
+            return sf::Event::FocusGained{};
+        case RecordedEventType::TextEntered:
+        {
+            std::uint32_t unicode = 0;
+            if (!readLE(in, unicode))
+                return std::nullopt;
+            return sf::Event::TextEntered{static_cast<char32_t>(unicode)};
+        }
+        case RecordedEventType::KeyPressed:
+            return readKey(sf::Event::KeyPressed{});
+        case RecordedEventType::KeyReleased:
+            return readKey(sf::Event::KeyReleased{});
+        case RecordedEventType::MouseWheelScrolled:
+        {
+            sf::Event::MouseWheelScrolled scrolled;
+            std::int32_t                  wheel = 0;
+            if (!readI32(in, wheel) || !readF32(in, scrolled.delta) || !readVector2i(in, scrolled.position))
+                return std::nullopt;
+            scrolled.wheel = static_cast<sf::Mouse::Wheel>(wheel);
+            return scrolled;
+        }
+        case RecordedEventType::MouseButtonPressed:
+            return readMouseButton(sf::Event::MouseButtonPressed{});
+        case RecordedEventType::MouseButtonReleased:
+            return readMouseButton(sf::Event::MouseButtonReleased{});
+        case RecordedEventType::MouseMoved:
+        {
+            sf::Event::MouseMoved mouseMoved;
+            if (!readVector2i(in, mouseMoved.position))
+                return std::nullopt;
+            return mouseMoved;
+        }
+        case RecordedEventType::TouchBegan:
+            return readTouch(sf::Event::TouchBegan{});
+        case RecordedEventType::TouchEnded:
+            return readTouch(sf::Event::TouchEnded{});
+        case RecordedEventType::JoystickConnected:
+            return readJoystickId(sf::Event::JoystickConnected{});
+        case RecordedEventType::JoystickDisconnected:
+            return readJoystickId(sf::Event::JoystickDisconnected{});
+    }
+    return std::nullopt;
+}
+
+void writeRecordedUpdate(std::ostream& out, sf::Time dt, sf::Vector2i mousePos, sf::Vector2f displaySize, std::uint8_t mouseDown)
+{
+    writeLE(out, static_cast<std::uint8_t>(InputRecordType::Update));
+    writeLE(out, static_cast<std::uint64_t>(dt.asMicroseconds()));
+    writeVector2i(out, mousePos);
+    writeF32(out, displaySize.x);
+    writeF32(out, displaySize.y);
+    writeLE(out, mouseDown);
+}
+
+// image atlas
+struct AtlasPage
+{
+    sf::Texture             texture;
+    bool                    smooth{false};
+    stbrp_context           packer{};
+    std::vector<stbrp_node> nodes;
+    std::uint32_t           generation{0};
+    std::uint64_t           lastUsedFrame{0};
+};
+
+struct ImageAtlas
+{
+    static constexpr unsigned int Padding        = 2;  // transparent gap between images
+    static constexpr unsigned int ClearStripRows = 16; // pages are cleared a strip at a time
+
+    std::optional<ImGui::SFML::ImageAtlasSettings> settings; // atlas is disabled if empty
+    std::vector<AtlasPage>                         pages;
+    std::vector<std::uint8_t>                      clearStrip; // transparent pixels, pageSize x ClearStripRows
+};
+
+ImageAtlas s_imageAtlas;
+
+void resetAtlasPage(AtlasPage& page, bool smooth)
+{
+    const unsigned int pageSize = s_imageAtlas.settings->pageSize;
+
+    // images are padded with transparent pixels so that filtering doesn't bleed between them
+    std::vector<std::uint8_t>& strip = s_imageAtlas.clearStrip;
+    strip.resize(std::size_t{pageSize} * ImageAtlas::ClearStripRows * 4, 0);
+    for (unsigned int y = 0; y < pageSize; y += ImageAtlas::ClearStripRows)
+        page.texture.update(strip.data(), {pageSize, std::min(ImageAtlas::ClearStripRows, pageSize - y)}, {0, y});
+    page.texture.setSmooth(smooth);
+    page.smooth = smooth;
+
+    page.nodes.resize(pageSize);
+    stbrp_init_target(&page.packer,
+                      static_cast<int>(pageSize),
+                      static_cast<int>(pageSize),
+                      page.nodes.data(),
+                      static_cast<int>(page.nodes.size()));
+    ++page.generation;
+}
+
+[[nodiscard]] bool packAtlasRect(AtlasPage& page, sf::Vector2u size, sf::Vector2u& position)
+{
+    stbrp_rect rect{};
+    rect.w = static_cast<stbrp_coord>(size.x + ImageAtlas::Padding);
+    rect.h = static_cast<stbrp_coord>(size.y + ImageAtlas::Padding);
+    if (stbrp_pack_rects(&page.packer, &rect, 1) == 0)
+        return false;
+
+    position = sf::Vector2u(sf::Vector2(rect.x, rect.y));
+    return true;
+}
+
+// Finds room for an image of the given size, evicting the least recently used page if needed
+[[nodiscard]] std::optional<std::size_t> allocateAtlasRect(sf::Vector2u size, bool smooth, sf::Vector2u& position)
+{
+    std::vector<AtlasPage>& pages = s_imageAtlas.pages;
+    for (std::size_t i = 0; i < pages.size(); ++i)
+    {
+        if (pages[i].smooth == smooth && packAtlasRect(pages[i], size, position))
+            return i;
+    }
+
+    if (pages.size() < s_imageAtlas.settings->maxPages)
+    {
+        AtlasPage page;
+        if (!page.texture.resize({s_imageAtlas.settings->pageSize, s_imageAtlas.settings->pageSize}))
+            return std::nullopt;
+
+        resetAtlasPage(page, smooth);
+        pages.push_back(std::move(page));
+        return packAtlasRect(pages.back(), size, position) ? std::optional(pages.size() - 1) : std::nullopt;
+    }
+
+    const auto lru = std::min_element(pages.begin(),
+                                      pages.end(),
+                                      [](const AtlasPage& a, const AtlasPage& b)
+                                      { return a.lastUsedFrame < b.lastUsedFrame; });
+    if (mayBeInFlight(lru->lastUsedFrame))
+        return std::nullopt;
+
+    resetAtlasPage(*lru, smooth);
+    const auto index = static_cast<std::size_t>(lru - pages.begin());
+    return packAtlasRect(*lru, size, position) ? std::optional(index) : std::nullopt;
+}
+
+// Returns the atlas slot of a registered texture, copying it into the atlas if needed
+[[nodiscard]] const AtlasSlot* getAtlasSlot(RegisteredTexture& entry, const sf::Texture& texture)
+{
+    const ImGui::SFML::ImageAtlasSettings& settings = *s_imageAtlas.settings;
+
+    const sf::Vector2u size = texture.getSize();
+    if (size.x == 0 || size.y == 0 || size.x > settings.maxImageSize || size.y > settings.maxImageSize ||
+        (entry.sampler && entry.sampler->repeated))
+    {
+        return nullptr;
+    }
+
+    const bool smooth = entry.sampler ? entry.sampler->smooth : texture.isSmooth();
+
+    std::optional<AtlasSlot>& slot = entry.atlasSlot;
+    if (slot && (slot->page >= s_imageAtlas.pages.size() ||
+                 slot->pageGeneration != s_imageAtlas.pages[slot->page].generation ||
+                 slot->sourceHandle != texture.getNativeHandle() || slot->size != size || slot->smooth != smooth))
+    {
+        slot.reset();
+    }
+
+    if (!slot)
+    {
+        sf::Vector2u                     position;
+        const std::optional<std::size_t> page = allocateAtlasRect(size, smooth, position);
+        if (!page)
+            return nullptr;
+
+        AtlasPage& atlasPage = s_imageAtlas.pages[*page];
+        atlasPage.texture.update(texture, position);
+        slot = AtlasSlot{*page, atlasPage.generation, position, size, texture.getNativeHandle(), smooth};
+    }
+
+    s_imageAtlas.pages[slot->page].lastUsedFrame = s_frameCounter;
+    return &*slot;
+}
+
+TextureData getTextureData(const sf::Texture& texture, ImVec2 uv0, ImVec2 uv1)
+{
+    if (s_imageAtlas.settings)
+    {
+        const auto found = s_textureRegistry.indices.find(&texture);
+        if (found != s_textureRegistry.indices.end())
+        {
+            if (const AtlasSlot* slot = getAtlasSlot(s_textureRegistry.entries[found->second], texture))
+            {
+                const AtlasPage&   page     = s_imageAtlas.pages[slot->page];
+                const sf::Vector2f pageSize(page.texture.getSize());
+
+                // stay half a texel inside the image when filtering, so that edges don't fade out
+                const float        inset = slot->smooth ? 0.5f : 0.f;
+                const sf::Vector2f origin(sf::Vector2f(slot->position) + sf::Vector2f(inset, inset));
+                const sf::Vector2f extent(sf::Vector2f(slot->size) - sf::Vector2f(2 * inset, 2 * inset));
+                const auto         toAtlas = [&](ImVec2 uv)
+                { return toImVec2((origin + toSfVector2f(uv).componentWiseMul(extent)).componentWiseDiv(pageSize)); };
+
+                return {toAtlas(uv0), toAtlas(uv1), convertGLTextureHandleToImTextureID(page.texture.getNativeHandle())};
+            }
+        }
+    }
+
+    return {uv0, uv1, getTextureID(texture)};
+}
+
+void trackDrawListUsage(WindowContext& ctx, const ImDrawList& drawList)
+{
+    const auto [it, inserted] = ctx.drawListUsage.try_emplace(&drawList);
+    DrawListUsage& usage      = it->second;
+    if (inserted || usage.lastSeenFrame + s_windowContexts.size() < s_frameCounter)
+        usage = DrawListUsage{0, 0, 0, s_frameCounter, s_frameCounter}; // new, hidden for a while or reused address
+
+    usage.peakVtxCount  = std::max(usage.peakVtxCount, drawList.VtxBuffer.Size);
+    usage.peakIdxCount  = std::max(usage.peakIdxCount, drawList.IdxBuffer.Size);
+    usage.peakCmdCount  = std::max(usage.peakCmdCount, drawList.CmdBuffer.Size);
+    usage.lastSeenFrame = s_frameCounter;
+}
+
+void samplePacerInput(FramePacer& pacer, sf::Vector2f mousePos)
+{
+    const sf::Time now = s_pacingClock.getElapsedTime();
+    pacer.sampleTime   = now;
+
+    if (pacer.lastMousePos && now > pacer.lastMouseTime)
+    {
+        const sf::Vector2f velocity = (mousePos - *pacer.lastMousePos) / (now - pacer.lastMouseTime).asSeconds();
+        pacer.mouseVelocity += (velocity - pacer.mouseVelocity) * 0.5f;
+    }
+    pacer.lastMousePos  = mousePos;
+    pacer.lastMouseTime = now;
+}
+
+[[nodiscard]] std::optional<sf::Vector2f> predictCursorPosition(const FramePacer& pacer)
+{
+    if (!pacer.settings || !pacer.settings->predictCursor || !pacer.lastMousePos || !ImGui::GetIO().MouseDrawCursor)
+        return std::nullopt;
+
+    // don't extrapolate far, predictions get wrong quickly when the mouse changes direction
+    const float horizon = std::min(pacer.latencyEstimate.asSeconds(), 0.05f);
+    return toSfVector2f(ImGui::GetIO().MousePos) + pacer.mouseVelocity * horizon;
+}
+
+// Squared distance transform of one row or column (Felzenszwalb & Huttenlocher)
+void distanceTransform1D(float*                    grid,
+                         std::size_t               offset,
+                         std::size_t               stride,
+                         std::size_t               length,
+                         std::vector<float>&       f,
+                         std::vector<std::size_t>& v,
+                         std::vector<float>&       z)
+{
+    for (std::size_t q = 0; q < length; ++q)
+        f[q] = grid[offset + q * stride];
+
+    const auto intersection = [&f](std::size_t q, std::size_t r)
+    {
+        const auto qf = static_cast<float>(q);
+        const auto rf = static_cast<float>(r);
+        return ((f[q] + qf * qf) - (f[r] + rf * rf)) / (2.f * (qf - rf));
+    };
+
+    std::size_t k = 0;
+    v[0]          = 0;
+    z[0]          = -FLT_MAX;
+    z[1]          = FLT_MAX;
+    for (std::size_t q = 1; q < length; ++q)
+    {
+        float s = intersection(q, v[k]);
+        while (k > 0 && s <= z[k])
+            s = intersection(q, v[--k]);
+        ++k;
+        v[k]     = q;
+        z[k]     = s;
+        z[k + 1] = FLT_MAX;
+    }
+
+    k = 0;
+    for (std::size_t q = 0; q < length; ++q)
+    {
+        while (z[k + 1] < static_cast<float>(q))
+            ++k;
+        const float d             = static_cast<float>(q) - static_cast<float>(v[k]);
+        grid[offset + q * stride] = d * d + f[v[k]];
+    }
+}
+
+void distanceTransform2D(std::vector<float>& grid, std::size_t width, std::size_t height)
+{
+    const std::size_t        length = std::max(width, height);
+    std::vector<float>       f(length);
+    std::vector<std::size_t> v(length);
+    std::vector<float>       z(length + 1);
+    for (std::size_t x = 0; x < width; ++x)
+        distanceTransform1D(grid.data(), x, width, height, f, v, z);
+    for (std::size_t y = 0; y < height; ++y)
+        distanceTransform1D(grid.data(), y * width, 1, width, f, v, z);
+}
+
+// Replaces the coverage of an alpha atlas by the signed distance to the glyphs' outlines, mapped
+// so that 0.5 is on the outline and 0 and 1 are spread pixels outside and inside of it
+void convertToDistanceField(unsigned char* pixels, std::size_t width, std::size_t height, float spread)
+{
+    constexpr float    far = 1e20f;
+    std::vector<float> outer(width * height);
+    std::vector<float> inner(width * height);
+    for (std::size_t i = 0; i < width * height; ++i)
+    {
+        // anti-aliased pixels put the outline somewhere inside of them
+        const float coverage = static_cast<float>(pixels[i]) / 255.f;
+        const float outside  = std::max(0.5f - coverage, 0.f);
+        const float inside   = std::max(coverage - 0.5f, 0.f);
+        outer[i]             = coverage <= 0.f ? far : outside * outside;
+        inner[i]             = coverage >= 1.f ? far : inside * inside;
+    }
+
+    distanceTransform2D(outer, width, height);
+    distanceTransform2D(inner, width, height);
+
+    for (std::size_t i = 0; i < width * height; ++i)
+    {
+        const float distance = std::sqrt(outer[i]) - std::sqrt(inner[i]); // positive outside
+        const float value    = std::clamp(0.5f - distance / (2.f * spread), 0.f, 1.f);
+        pixels[i]            = static_cast<unsigned char>(std::lround(value * 255.f));
+    }
+}
+
+// Fonts are matched by their index, which is the same in every scaled atlas
+[[nodiscard]] ImFont* findScaledFont(ImFont* font, const ImFontAtlas& from, const ImFontAtlas& to)
+{
+    for (int i = 0; font && i < from.Fonts.Size && i < to.Fonts.Size; ++i)
+    {
+        if (from.Fonts[i] == font)
+            return to.Fonts[i];
+    }
+    return nullptr;
+}
+
+void setFontAtlas(DpiState& dpi, ImFontAtlas& atlas, float scale)
+{
+    ImGuiIO& io        = ImGui::GetIO();
+    io.FontDefault     = findScaledFont(io.FontDefault, *io.Fonts, atlas);
+    io.Fonts           = &atlas;
+    io.FontGlobalScale = 1.f / scale; // keeps the layout in window coordinates
+    dpi.currentScale   = scale;
+}
+
+[[nodiscard]] ScaledFontAtlas* bakeScaledFontAtlas(DpiState& dpi, float scale)
+{
+    // make room first, the current atlas is never the least recently used one
+    if (dpi.atlases.size() >= dpi.settings->maxCachedAtlases && !dpi.atlases.empty())
+    {
+        dpi.atlases.erase(std::min_element(dpi.atlases.begin(),
+                                           dpi.atlases.end(),
+                                           [](const ScaledFontAtlas& a, const ScaledFontAtlas& b)
+                                           { return a.lastUsedFrame < b.lastUsedFrame; }));
+    }
+    if (dpi.settings->maxCachedAtlases == 0)
+        return nullptr;
+
+    const ImFontAtlas& base = *dpi.baseAtlas;
+    ScaledFontAtlas    scaled;
+    scaled.scale = scale;
+    scaled.atlas.reset(IM_NEW(ImFontAtlas));
+    scaled.atlas->Flags           = base.Flags;
+    scaled.atlas->TexDesiredWidth = base.TexDesiredWidth;
+    scaled.atlas->TexGlyphPadding = base.TexGlyphPadding;
+    for (const ImFontConfig& baseConfig : base.ConfigData)
+    {
+        ImFontConfig config = baseConfig;
+        config.SizePixels   = baseConfig.SizePixels * scale;
+        // AddFont gives the scaled atlas its own copy of the data, the base atlas may free its one
+        config.FontDataOwnedByAtlas = false;
+        // merged fonts go into the scaled copy of their font, the others get a new one
+        config.DstFont = baseConfig.MergeMode ? findScaledFont(baseConfig.DstFont, base, *scaled.atlas) : nullptr;
+        scaled.atlas->AddFont(&config);
+    }
+
+    unsigned char* pixels = nullptr;
+    int            width  = 0;
+    int            height = 0;
+    scaled.atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+    if (!scaled.texture.resize(sf::Vector2u(sf::Vector2(width, height))))
+        return nullptr;
+
+    scaled.texture.update(pixels);
+    scaled.atlas->SetTexID(convertGLTextureHandleToImTextureID(scaled.texture.getNativeHandle()));
+    scaled.atlas->ClearTexData(); // only the texture is needed from now on
+
+    dpi.atlases.push_back(std::move(scaled));
+    return &dpi.atlases.back();
+}
+
+// Swaps to the atlas baked for the given framebuffer scale, baking it if it isn't cached
+void selectFontAtlas(DpiState& dpi, float framebufferScale)
+{
+    // quarter steps bound the number of atlases a window can go through
+    const float scale = std::max(std::round(framebufferScale * 4.f) / 4.f, 0.25f);
+
+    if (!dpi.baseAtlas)
+        dpi.baseAtlas = ImGui::GetIO().Fonts;
+
+    if (scale == 1.f)
+    {
+        if (dpi.currentScale != 1.f)
+            setFontAtlas(dpi, *dpi.baseAtlas, 1.f);
+        return;
+    }
+
+    auto found = std::find_if(dpi.atlases.begin(),
+                              dpi.atlases.end(),
+                              [scale](const ScaledFontAtlas& atlas) { return atlas.scale == scale; });
+    ScaledFontAtlas* atlas = found != dpi.atlases.end() ? &*found : bakeScaledFontAtlas(dpi, scale);
+    if (!atlas)
+        return; // keep the current fonts
+
+    atlas->lastUsedFrame = s_frameCounter;
+    if (dpi.currentScale != scale)
+        setFontAtlas(dpi, *atlas->atlas, scale);
+}
+
+// Goes back to the base atlas and forgets the scaled ones
+void resetFontAtlases(DpiState& dpi)
+{
+    if (dpi.baseAtlas && dpi.currentScale != 1.f)
+        setFontAtlas(dpi, *dpi.baseAtlas, 1.f);
+    dpi.atlases.clear();
+}
+
+void releaseAtlasPages()
+{
+    s_imageAtlas.pages.clear();
+    s_imageAtlas.clearStrip = {};
+    for (RegisteredTexture& entry : s_textureRegistry.entries)
+        entry.atlasSlot.reset();
+}
+
+// render texture pool for viewport widgets
+struct PooledRenderTexture
+{
+    sf::RenderTexture texture;
+    std::uint64_t     lastUsedFrame{0};
+};
+
+struct ViewportState
+{
+    ImGuiContext* imContext{nullptr};
+    ImGuiID       id{0};
+
+    PooledRenderTexture* target{nullptr}; // reused on the next frame if it's still large enough
+    sf::Vector2u         pixelSize;
+    sf::Vector2f         size;
+    std::uint64_t        lastUsedFrame{0};
+
+    float    resolutionScale{1.f};
+    GpuTimer gpuTimer; // measures the viewport's own drawing, not the UI pass
+    bool     gpuTimerStarted{false};
+};
+
+struct RenderTexturePool
+{
+    static constexpr unsigned int  MinBucketSize = 64;
+    static constexpr std::uint64_t IdleFrames    = 300; // unused textures and viewports are released after this
+
+    std::vector<std::unique_ptr<PooledRenderTexture>> textures;
+    std::vector<std::unique_ptr<ViewportState>>       viewports;
+    ViewportState*                                    current{nullptr}; // between BeginViewport and EndViewport
+    bool                                              skipped{false};   // the last BeginViewport returned nullptr
+};
+
+RenderTexturePool s_renderTexturePool;
+
+// Deletes the queries of the viewport's GPU timer, activating a context through its render texture if needed
+void releaseViewportGpuTimer(ViewportState& viewport)
+{
+    if (viewport.gpuTimer.initialized && sf::Context::getActiveContextId() != viewport.gpuTimer.contextId &&
+        viewport.target)
+    {
+        (void)viewport.target->texture.setActive();
+    }
+    releaseGpuTimer(viewport.gpuTimer);
+}
+
+// Texture sizes grow by 1.5x steps, so that resizing a panel only reallocates when crossing a bucket
+[[nodiscard]] unsigned int getRenderTextureBucketSize(unsigned int size)
+{
+    unsigned int bucketSize = RenderTexturePool::MinBucketSize;
+    while (bucketSize < size)
+        bucketSize += bucketSize / 2;
+    return bucketSize;
+}
+
+void releaseIdleRenderTextures()
+{
+    auto& textures = s_renderTexturePool.textures;
+    for (auto it = textures.begin(); it != textures.end();)
+    {
+        if ((*it)->lastUsedFrame + RenderTexturePool::IdleFrames >= s_frameCounter)
+        {
+            ++it;
+            continue;
+        }
+
+        for (const std::unique_ptr<ViewportState>& viewport : s_renderTexturePool.viewports)
+        {
+            if (viewport->target == it->get())
+            {
+                releaseViewportGpuTimer(*viewport);
+                viewport->target = nullptr;
+            }
+        }
+        it = textures.erase(it);
+    }
+
+    auto& viewports = s_renderTexturePool.viewports;
+    viewports.erase(std::remove_if(viewports.begin(),
+                                   viewports.end(),
+                                   [](const std::unique_ptr<ViewportState>& viewport)
+                                   {
+                                       if (viewport->lastUsedFrame + RenderTexturePool::IdleFrames >= s_frameCounter)
+                                           return false;
+                                       releaseViewportGpuTimer(*viewport);
+                                       return true;
+                                   }),
+                    viewports.end());
+}
+
+[[nodiscard]] ViewportState& getViewportState(ImGuiID id)
+{
+    ImGuiContext* const imContext = ImGui::GetCurrentContext();
+    for (const std::unique_ptr<ViewportState>& viewport : s_renderTexturePool.viewports)
+    {
+        if (viewport->imContext == imContext && viewport->id == id)
+            return *viewport;
+    }
+
+    auto viewport       = std::make_unique<ViewportState>();
+    viewport->imContext = imContext;
+    viewport->id        = id;
+    s_renderTexturePool.viewports.push_back(std::move(viewport));
+    return *s_renderTexturePool.viewports.back();
+}
+
+[[nodiscard]] bool fitsRenderTexture(const PooledRenderTexture& pooled, sf::Vector2u size)
+{
+    const sf::Vector2u textureSize = pooled.texture.getSize();
+    return textureSize.x >= size.x && textureSize.y >= size.y;
+}
+
+// Returns the smallest free pooled texture which is at least the given size, creating one if needed
+[[nodiscard]] PooledRenderTexture* acquireRenderTexture(sf::Vector2u size, PooledRenderTexture* previous)
+{
+    releaseIdleRenderTextures();
+
+    // the previous frame's draw list of the same viewport has been rendered already
+    if (previous && previous->lastUsedFrame != s_frameCounter && fitsRenderTexture(*previous, size))
+    {
+        previous->lastUsedFrame = s_frameCounter;
+        return previous;
+    }
+
+    PooledRenderTexture* best = nullptr;
+    for (const std::unique_ptr<PooledRenderTexture>& pooled : s_renderTexturePool.textures)
+    {
+        if (mayBeInFlight(pooled->lastUsedFrame) || !fitsRenderTexture(*pooled, size))
+            continue;
+
+        const sf::Vector2u textureSize = pooled->texture.getSize();
+        if (!best || textureSize.x * textureSize.y < best->texture.getSize().x * best->texture.getSize().y)
+            best = pooled.get();
+    }
+
+    if (!best)
+    {
+        auto pooled = std::make_unique<PooledRenderTexture>();
+        if (!pooled->texture.resize({getRenderTextureBucketSize(size.x), getRenderTextureBucketSize(size.y)}))
+            return nullptr;
+
+        pooled->texture.setSmooth(true); // filtered when upscaling from a lower resolution
+        s_renderTexturePool.textures.push_back(std::move(pooled));
+        best = s_renderTexturePool.textures.back().get();
+    }
+
+    best->lastUsedFrame = s_frameCounter;
+    return best;
+}
+
+// asynchronous images
+struct AsyncImageEntry
+{
+    std::filesystem::path        path;
+    ImGui::SFML::AsyncImageState state{ImGui::SFML::AsyncImageState::Unloaded};
+    std::unique_ptr<sf::Texture> texture; // registered, so its address must not change
+    std::uint32_t                request{0}; // incremented when cancelled, so that late results are dropped
+    std::uint64_t                lastVisibleFrame{0};
+};
+
+struct AsyncImageJob
+{
+    std::uint32_t         id{0};
+    std::uint32_t         request{0};
+    std::filesystem::path path;
+};
+
+struct DecodedAsyncImage
+{
+    std::uint32_t                id{0};
+    std::uint32_t                request{0};
+    std::optional<sf::Image>     image; // empty if the file couldn't be decoded
+    std::unique_ptr<sf::Texture> texture; // created by the first upload
+    unsigned int                 uploadedRows{0};
+};
+
+struct AsyncImageLoader
+{
+    ImGui::SFML::AsyncImageSettings                                       settings;
+    std::vector<AsyncImageEntry>                                          entries; // handle ids start at 1
+    std::unordered_map<std::filesystem::path::string_type, std::uint32_t> ids;
+    std::deque<DecodedAsyncImage>                                         uploads; // waiting for the upload budget
+
+    // shared with the workers
+    std::mutex                     mutex;
+    std::condition_variable        jobAdded;
+    std::deque<AsyncImageJob>      jobs;
+    std::vector<DecodedAsyncImage> results;
+    bool                           stopping{false};
+
+    std::vector<std::thread> workers;
+};
+
+std::unique_ptr<AsyncImageLoader> s_asyncImages; // disabled if null
+
+// Box filter, each pixel of the result averages the pixels of the source it covers
+[[nodiscard]] sf::Image downscaleImage(const sf::Image& image, const sf::Vector2u& maxSize)
+{
+    const sf::Vector2u size  = image.getSize();
+    const float        scale = std::min(static_cast<float>(maxSize.x) / static_cast<float>(size.x),
+                                 static_cast<float>(maxSize.y) / static_cast<float>(size.y));
+    if (scale >= 1.f)
+        return image;
+
+    const sf::Vector2u scaledSize(std::max(1u, static_cast<unsigned int>(static_cast<float>(size.x) * scale)),
+                                  std::max(1u, static_cast<unsigned int>(static_cast<float>(size.y) * scale)));
+    const std::uint8_t*       source = image.getPixelsPtr();
+    std::vector<std::uint8_t> pixels(std::size_t{scaledSize.x} * scaledSize.y * 4);
+    for (unsigned int y = 0; y < scaledSize.y; ++y)
+    {
+        const unsigned int top    = y * size.y / scaledSize.y;
+        const unsigned int bottom = (y + 1) * size.y / scaledSize.y;
+        for (unsigned int x = 0; x < scaledSize.x; ++x)
+        {
+            const unsigned int left  = x * size.x / scaledSize.x;
+            const unsigned int right = (x + 1) * size.x / scaledSize.x;
+
+            std::size_t sums[4] = {};
+            for (unsigned int sy = top; sy < bottom; ++sy)
+            {
+                for (unsigned int sx = left; sx < right; ++sx)
+                {
+                    for (std::size_t c = 0; c < 4; ++c)
+                        sums[c] += source[(std::size_t{sy} * size.x + sx) * 4 + c];
+                }
+            }
+
+            const std::size_t  count  = std::size_t{bottom - top} * (right - left);
+            std::uint8_t*      result = &pixels[(std::size_t{y} * scaledSize.x + x) * 4];
+            for (std::size_t c = 0; c < 4; ++c)
+                result[c] = static_cast<std::uint8_t>((sums[c] + count / 2) / count);
+        }
+    }
+    return sf::Image(scaledSize, pixels.data());
+}
+
+void decodeAsyncImages(AsyncImageLoader& loader)
+{
+    std::unique_lock lock(loader.mutex);
+    while (true)
+    {
+        loader.jobAdded.wait(lock, [&loader] { return loader.stopping || !loader.jobs.empty(); });
+        if (loader.stopping)
+            return;
+
+        AsyncImageJob job = std::move(loader.jobs.front());
+        loader.jobs.pop_front();
+        lock.unlock();
+
+        DecodedAsyncImage decoded{job.id, job.request, std::nullopt, nullptr, 0};
+        sf::Image         image;
+        if (image.loadFromFile(job.path))
+        {
+            if (loader.settings.maxSize)
+                image = downscaleImage(image, *loader.settings.maxSize);
+            decoded.image = std::move(image);
+        }
+
+        lock.lock();
+        loader.results.push_back(std::move(decoded));
+    }
+}
+
+[[nodiscard]] AsyncImageEntry* findAsyncImage(ImGui::SFML::AsyncImage image)
+{
+    assert(s_asyncImages && "Asynchronous images aren't enabled");
+    if (!s_asyncImages || image.id == 0 || image.id > s_asyncImages->entries.size())
+        return nullptr;
+    return &s_asyncImages->entries[image.id - 1];
+}
+
+void releaseAsyncImageTexture(AsyncImageEntry& entry)
+{
+    ImGui::SFML::UnregisterTexture(*entry.texture);
+    entry.texture.reset();
+    entry.state = ImGui::SFML::AsyncImageState::Unloaded;
+}
+
+// Cancels the requests of images which are no longer visible, releases idle textures and uploads
+// strips of rows of the decoded images within the budget
+void updateAsyncImages(AsyncImageLoader& loader)
+{
+    using ImGui::SFML::AsyncImageState;
+
+    for (AsyncImageEntry& entry : loader.entries)
+    {
+        if (entry.state == AsyncImageState::Loading && !mayBeInFlight(entry.lastVisibleFrame))
+        {
+            entry.state = AsyncImageState::Unloaded;
+            ++entry.request;
+        }
+        else if (entry.state == AsyncImageState::Ready && !mayBeInFlight(entry.lastVisibleFrame) &&
+                 entry.lastVisibleFrame + loader.settings.idleFrames < s_frameCounter)
+        {
+            releaseAsyncImageTexture(entry);
+        }
+    }
+
+    {
+        const std::lock_guard lock(loader.mutex);
+        loader.jobs.erase(std::remove_if(loader.jobs.begin(),
+                                         loader.jobs.end(),
+                                         [&loader](const AsyncImageJob& job)
+                                         { return job.request != loader.entries[job.id - 1].request; }),
+                          loader.jobs.end());
+        std::move(loader.results.begin(), loader.results.end(), std::back_inserter(loader.uploads));
+        loader.results.clear();
+    }
+
+    std::size_t uploadedBytes = 0;
+    while (!loader.uploads.empty())
+    {
+        DecodedAsyncImage& decoded = loader.uploads.front();
+        AsyncImageEntry&   entry   = loader.entries[decoded.id - 1];
+        if (decoded.request != entry.request || entry.state != AsyncImageState::Loading)
+        {
+            loader.uploads.pop_front();
+            continue;
+        }
+
+        if (!decoded.texture)
+        {
+            decoded.texture = std::make_unique<sf::Texture>();
+            if (!decoded.image || !decoded.texture->resize(decoded.image->getSize()))
+            {
+                entry.state = AsyncImageState::Failed;
+                loader.uploads.pop_front();
+                continue;
+            }
+        }
+
+        // at least one row per call, so that rows larger than the budget are still uploaded
+        const sf::Vector2u size     = decoded.image->getSize();
+        const std::size_t  rowBytes = std::size_t{size.x} * 4;
+        unsigned int       rows     = size.y - decoded.uploadedRows;
+        if (uploadedBytes + rows * rowBytes > loader.settings.uploadBudget)
+        {
+            const std::size_t budgetRows = (std::max(loader.settings.uploadBudget, uploadedBytes) - uploadedBytes) /
+                                           rowBytes;
+            rows = static_cast<unsigned int>(std::max<std::size_t>(budgetRows, uploadedBytes == 0 ? 1 : 0));
+        }
+        if (rows == 0)
+            break;
+
+        decoded.texture->update(decoded.image->getPixelsPtr() + decoded.uploadedRows * rowBytes,
+                                sf::Vector2u(size.x, rows),
+                                sf::Vector2u(0, decoded.uploadedRows));
+        decoded.uploadedRows += rows;
+        uploadedBytes += rows * rowBytes;
+        if (decoded.uploadedRows < size.y)
+            break;
+
+        decoded.texture->setSmooth(true);
+        ImGui::SFML::RegisterTexture(*decoded.texture);
+        entry.texture = std::move(decoded.texture);
+        entry.state   = AsyncImageState::Ready;
+        loader.uploads.pop_front();
+    }
+}
+
+// Requests the image once it's visible, must be called right after drawing its item
+void touchAsyncImage(ImGui::SFML::AsyncImage image)
+{
+    AsyncImageEntry* entry = findAsyncImage(image);
+    if (!entry || !ImGui::IsItemVisible())
+        return;
+
+    entry->lastVisibleFrame = s_frameCounter;
+    if (entry->state != ImGui::SFML::AsyncImageState::Unloaded)
+        return;
+
+    entry->state = ImGui::SFML::AsyncImageState::Loading;
+    {
+        const std::lock_guard lock(s_asyncImages->mutex);
+        s_asyncImages->jobs.push_back(AsyncImageJob{image.id, entry->request, entry->path});
+    }
+    s_asyncImages->jobAdded.notify_one();
+}
+
+// Texture data of a ready image, or of the font atlas' white pixel, drawn as a placeholder
+[[nodiscard]] TextureData getAsyncImageTextureData(ImGui::SFML::AsyncImage image)
+{
+    const AsyncImageEntry* entry = findAsyncImage(image);
+    if (entry && entry->state == ImGui::SFML::AsyncImageState::Ready)
+        return getTextureData(*entry->texture);
+
+    const ImVec2 whitePixel = ImGui::GetIO().Fonts->TexUvWhitePixel;
+    return TextureData{whitePixel, whitePixel, ImGui::GetIO().Fonts->TexID};
+}
+
+// The placeholder is tinted like a frame
+[[nodiscard]] ImVec4 getAsyncImageTint(ImGui::SFML::AsyncImage image, const sf::Color& tintColor)
+{
+    const AsyncImageEntry* entry = findAsyncImage(image);
+    if (entry && entry->state == ImGui::SFML::AsyncImageState::Ready)
+        return toImColor(tintColor);
+    return ImGui::GetStyleColorVec4(ImGuiCol_FrameBg);
+}
+
+} // end of anonymous namespace
+
+namespace ImGui
+{
+namespace SFML
+{
+bool Init(sf::RenderWindow& window, bool loadDefaultFont)
+{
+    return Init(window, window, loadDefaultFont);
+}
+
+bool Init(sf::Window& window, sf::RenderTarget& target, bool loadDefaultFont)
+{
+    return Init(window, sf::Vector2f(target.getSize()), loadDefaultFont);
+}
+
+bool Init(sf::Window& window, const sf::Vector2f& displaySize, bool loadDefaultFont)
+{
+    InitOptions options;
+    options.loadDefaultFont = loadDefaultFont;
+    return Init(window, displaySize, options);
+}
+
+bool Init(sf::RenderWindow& window, const InitOptions& options)
+{
+    return Init(window, window, options);
+}
+
+bool Init(sf::Window& window, sf::RenderTarget& target, const InitOptions& options)
+{
+    return Init(window, sf::Vector2f(target.getSize()), options);
+}
+
+bool Init(sf::Window& window, const sf::Vector2f& displaySize, const InitOptions& options)
+{
+#ifdef IMGUI_SFML_SHADER_RENDERER
+    // a window which isn't open has no context to check yet
+    if (window.isOpen() && window.setActive(true) && !isShaderRendererSupported())
+        return false;
+#endif
+
+    if (options.useContextAllocator)
+        installAllocatorFunctions();
+
+    std::unique_ptr<WindowContext> ctx    = takePooledContext(window, options.useContextAllocator);
+    const bool                     reused = ctx != nullptr;
+    if (!reused)
+        ctx = std::make_unique<WindowContext>(&window, options.useContextAllocator);
+    setCurrentWindowContext(s_windowContexts.emplace_back(std::move(ctx)).get());
+
+    ImGuiIO&         io          = ImGui::GetIO();
+    ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
+
+    // tell ImGui which features we support
+    io.BackendFlags |= ImGuiBackendFlags_HasGamepad;
+    io.BackendFlags |= ImGuiBackendFlags_HasMouseCursors;
+    io.BackendFlags |= ImGuiBackendFlags_HasSetMousePos;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+    io.BackendPlatformName = "imgui_impl_sfml";
+
+    s_currWindowCtx->joystickId = getConnectedJoystickId();
+
+    if (reused)
+    {
+        // drop the input state of the previous window
+        io.ClearEventsQueue();
+        io.ClearInputKeys();
+        io.ClearInputMouse(); // ClearInputKeys leaves the mouse buttons held
+        io.AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+
+        // the new window may be displayed at another scale, or not want DPI scaling at all
+        s_currWindowCtx->dpi.settings.reset();
+        if (s_currWindowCtx->dpi.currentScale != 1.f)
+        {
+            setFontAtlas(s_currWindowCtx->dpi, *s_currWindowCtx->dpi.baseAtlas, 1.f);
+            io.DisplayFramebufferScale = ImVec2(1.f, 1.f);
+        }
+    }
+    else
+    {
+        initDefaultJoystickMapping();
+    }
+
+    // init rendering
+    io.DisplaySize = toImVec2(displaySize);
+
+    // clipboard
+    platform_io.Platform_SetClipboardTextFn = setClipboardText;
+    platform_io.Platform_GetClipboardTextFn = getClipboardText;
+
+    // a reused context keeps its uploaded font texture
+    if (options.loadDefaultFont && !s_currWindowCtx->fontTexture)
+    {
+        // this will load default font automatically
+        // No need to call AddDefaultFont
+        return UpdateFontTexture();
+    }
+
+    return true;
+}
+
+void SetCurrentWindow(const sf::Window& window)
+{
+    auto found = std::find_if(s_windowContexts.begin(),
+                              s_windowContexts.end(),
+                              [&](std::unique_ptr<WindowContext>& ctx)
+                              { return ctx->window->getNativeHandle() == window.getNativeHandle(); });
+    assert(found != s_windowContexts.end() &&
+           "Failed to find the window. Forgot to call ImGui::SFML::Init for the window?");
+    setCurrentWindowContext(found->get());
+}
+
+void ProcessEvent(const sf::Window& window, const sf::Event& event)
+{
+    SetCurrentWindow(window);
+    assert(s_currWindowCtx && "No current window is set - forgot to call ImGui::SFML::Init?");
+    ImGuiIO& io = ImGui::GetIO();
+
+    if (s_currWindowCtx->inputRecording)
+        writeRecordedEvent(*s_currWindowCtx->inputRecording, event);
+
+    const bool tracing = s_tracing.enabled.load(std::memory_order_acquire);
+    if (tracing && !s_currWindowCtx->eventBatchBegin)
+        s_currWindowCtx->eventBatchBegin = s_tracing.clock.getElapsedTime();
+
+    if (s_currWindowCtx->windowHasFocus)
+    {
+        if (const auto* resized = event.getIf<sf::Event::Resized>())
+        {
+            io.DisplaySize = toImVec2(sf::Vector2f(resized->size));
+        }
+        else if (const auto* mouseMoved = event.getIf<sf::Event::MouseMoved>())
+        {
+            const auto [x, y] = sf::Vector2f(mouseMoved->position) / layoutScale(s_currWindowCtx->dpi);
+            io.AddMousePosEvent(x, y);
+            s_currWindowCtx->mouseMoved = true;
+        }
+        else if (const auto* mouseButtonPressed = event.getIf<sf::Event::MouseButtonPressed>())
+        {
+            const int button = static_cast<int>(mouseButtonPressed->button);
+            if (button >= 0 && button < 3)
+            {
+                s_currWindowCtx->mousePressed[static_cast<int>(mouseButtonPressed->button)] = true;
+                io.AddMouseButtonEvent(button, true);
+            }
+        }
+        else if (const auto* mouseButtonReleased = event.getIf<sf::Event::MouseButtonReleased>())
+        {
+            const int button = static_cast<int>(mouseButtonReleased->button);
+            if (button >= 0 && button < 3)
+                io.AddMouseButtonEvent(button, false);
+        }
+        else if (const auto* touchBegan = event.getIf<sf::Event::TouchBegan>())
+        {
+            s_currWindowCtx->mouseMoved = false;
+            const unsigned int button   = touchBegan->finger;
+            if (button < 3)
+                s_currWindowCtx->touchDown[touchBegan->finger] = true;
+        }
+        else if (event.is<sf::Event::TouchEnded>())
+        {
+            s_currWindowCtx->mouseMoved = false;
+        }
+        else if (const auto* mouseWheelScrolled = event.getIf<sf::Event::MouseWheelScrolled>())
+        {
+            if (mouseWheelScrolled->wheel == sf::Mouse::Wheel::Vertical ||
+                (mouseWheelScrolled->wheel == sf::Mouse::Wheel::Horizontal && io.KeyShift))
+            {
+                io.AddMouseWheelEvent(0, mouseWheelScrolled->delta);
+            }
+            else if (mouseWheelScrolled->wheel == sf::Mouse::Wheel::Horizontal)
+            {
+                io.AddMouseWheelEvent(mouseWheelScrolled->delta, 0);
+            }
+        }
+        const auto handleKeyChanged = [&io](const auto& keyChanged, bool down)
+        {
+            const ImGuiKey mod = keycodeToImGuiMod(keyChanged.code);
+            // The modifier booleans are not reliable when it's the modifier
+            // itself that's being pressed. Detect these presses directly.
+            if (mod != ImGuiKey_None)
+            {
+                io.AddKeyEvent(mod, down);
+            }
+            else
+            {
+                io.AddKeyEvent(ImGuiMod_Ctrl, keyChanged.control);
+                io.AddKeyEvent(ImGuiMod_Shift, keyChanged.shift);
+                io.AddKeyEvent(ImGuiMod_Alt, keyChanged.alt);
+                io.AddKeyEvent(ImGuiMod_Super, keyChanged.system);
+            }
+
+            const ImGuiKey key = keycodeToImGuiKey(keyChanged.code);
+            io.AddKeyEvent(key, down);
+            io.SetKeyEventNativeData(key, static_cast<int>(keyChanged.code), -1);
+        };
+        if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
+        {
+            handleKeyChanged(*keyPressed, true);
+        }
+        else if (const auto* keyReleased = event.getIf<sf::Event::KeyReleased>())
+        {
+            handleKeyChanged(*keyReleased, false);
+        }
+        else if (const auto* textEntered = event.getIf<sf::Event::TextEntered>())
+        {
+            // Don't handle the event for unprintable characters
+            if (textEntered->unicode >= ' ' && textEntered->unicode != 127)
+                io.AddInputCharacter(textEntered->unicode);
+        }
+        else if (const auto* joystickConnected = event.getIf<sf::Event::JoystickConnected>())
+        {
+            if (s_currWindowCtx->joystickId == NULL_JOYSTICK_ID)
+                s_currWindowCtx->joystickId = joystickConnected->joystickId;
+        }
+        else if (const auto* joystickDisconnected = event.getIf<sf::Event::JoystickDisconnected>())
+        {
+            if (s_currWindowCtx->joystickId == joystickDisconnected->joystickId)
+                // used gamepad was disconnected
+                s_currWindowCtx->joystickId = getConnectedJoystickId();
+        }
+    }
+
+    if (event.is<sf::Event::FocusLost>())
+    {
+        io.AddFocusEvent(false);
+        s_currWindowCtx->windowHasFocus = false;
+    }
+    if (event.is<sf::Event::FocusGained>())
+    {
+        io.AddFocusEvent(true);
+        s_currWindowCtx->windowHasFocus = true;
+    }
+
+    if (tracing)
+        s_currWindowCtx->eventBatchEnd = s_tracing.clock.getElapsedTime();
+}
+
+void Update(sf::RenderWindow& window, sf::Time dt)
+{
+    Update(window, window, dt);
+}
+
+void Update(sf::Window& window, sf::RenderTarget& target, sf::Time dt)
+{
+    SetCurrentWindow(window);
+    assert(s_currWindowCtx);
+
+    // Update OS/hardware mouse cursor if imgui isn't drawing a software cursor
+    const ImGuiMouseCursor mouse_cursor = ImGui::GetIO().MouseDrawCursor ? ImGuiMouseCursor_None : ImGui::GetMouseCursor();
+    if (s_currWindowCtx->lastCursor != mouse_cursor)
+    {
+        s_currWindowCtx->lastCursor = mouse_cursor;
+        updateMouseCursor(window);
+    }
+
+    sf::Vector2f displaySize(target.getSize());
+    if (s_currWindowCtx->dpi.settings && window.getSize().x > 0 && window.getSize().y > 0)
+    {
+        // layout happens in window coordinates scaled down by the monitor's content scale, rendering
+        // at the framebuffer's resolution
+        const sf::Vector2f layoutSize = sf::Vector2f(window.getSize()) / s_currWindowCtx->dpi.contentScale;
+        ImGui::GetIO().DisplayFramebufferScale = toImVec2(displaySize.componentWiseDiv(layoutSize));
+        displaySize                            = layoutSize;
+    }
+
+    if (!s_currWindowCtx->mouseMoved)
+    {
+        if (sf::Touch::isDown(0))
+            s_currWindowCtx->touchPos = sf::Touch::getPosition(0, window);
+
+        Update(s_currWindowCtx->touchPos, displaySize, dt);
+    }
+    else
+    {
+        Update(sf::Mouse::getPosition(window), displaySize, dt);
+    }
+}
+
+void Update(const sf::Vector2i& mousePos, const sf::Vector2f& displaySize, sf::Time dt)
+{
+    assert(s_currWindowCtx && "No current window is set - forgot to call ImGui::SFML::Init?");
+
+    flushEventBatchTrace(*s_currWindowCtx);
+    const TraceScope traceScope(TracePhase::Update);
+
+    ++s_frameCounter;
+    s_currWindowCtx->drawableCommands.clear();
+    s_currWindowCtx->primitiveBatches.clear();
+    s_currWindowCtx->primitiveInstances.clear();
+    if (s_asyncImages)
+        updateAsyncImages(*s_asyncImages);
+
+    if (ContextAllocator* allocator = s_currWindowCtx->allocator.get())
+        allocator->stats.allocationsLastFrame = std::exchange(allocator->allocationsThisFrame, 0);
+
+    ImGuiIO& io    = ImGui::GetIO();
+    io.DisplaySize = toImVec2(displaySize);
+    io.DeltaTime   = dt.asSeconds();
+
+    // the devices belong to the desktop, a window which was never opened only gets events
+    const bool   replaying   = s_currWindowCtx->replaying;
+    const bool   pollDevices = !replaying && s_currWindowCtx->window->isOpen();
+    std::uint8_t mouseDown   = 0; // sampled from the devices, recorded for replays
+    if (s_currWindowCtx->windowHasFocus)
+    {
+        if (io.WantSetMousePos)
+        {
+            if (pollDevices)
+                sf::Mouse::setPosition(sf::Vector2i(toSfVector2f(io.MousePos) * layoutScale(s_currWindowCtx->dpi)));
+        }
+        else
+        {
+            io.MousePos = toImVec2(sf::Vector2f(mousePos) / layoutScale(s_currWindowCtx->dpi));
+        }
+        for (unsigned int i = 0; i < 3; i++)
+        {
+            bool devicePressed = false;
+            if (replaying)
+                devicePressed = ((s_currWindowCtx->replayMouseDown >> i) & 1) != 0;
+            else if (pollDevices)
+                devicePressed = sf::Touch::isDown(i) || sf::Mouse::isButtonPressed((sf::Mouse::Button)i);
+            mouseDown       = static_cast<std::uint8_t>(mouseDown | (devicePressed ? 1 << i : 0));
+            io.MouseDown[i] = s_currWindowCtx->touchDown[i] || s_currWindowCtx->mousePressed[i] || devicePressed;
+            s_currWindowCtx->mousePressed[i] = false;
+            s_currWindowCtx->touchDown[i]    = false;
+        }
+    }
+
+    if (s_currWindowCtx->inputRecording)
+        writeRecordedUpdate(*s_currWindowCtx->inputRecording, dt, mousePos, displaySize, mouseDown);
+
+    if (s_currWindowCtx->pacer.settings)
+        samplePacerInput(s_currWindowCtx->pacer, sf::Vector2f(mousePos));
+
+#ifdef ANDROID
+#ifdef USE_JNI
+    if (io.WantTextInput && !s_currWindowCtx->wantTextInput)
+    {
+        openKeyboardIME();
+        s_currWindowCtx->wantTextInput = true;
+    }
+
+    if (!io.WantTextInput && s_currWindowCtx->wantTextInput)
+    {
+        closeKeyboardIME();
+        s_currWindowCtx->wantTextInput = false;
+    }
+#endif
+#endif
+
+    if (s_currWindowCtx->dpi.settings)
+    {
+        const ImVec2 framebufferScale = io.DisplayFramebufferScale;
+        // distance fields stay sharp at any scale, so only the base atlas is needed
+        const float scale = s_currWindowCtx->sdf ? 1.f : std::max(framebufferScale.x, framebufferScale.y);
+        selectFontAtlas(s_currWindowCtx->dpi, scale);
+    }
+
+    assert(io.Fonts->Fonts.Size > 0); // You forgot to create and set up font
+                                      // atlas (see createFontTexture)
+
+    // gamepad navigation
+    if ((io.ConfigFlags & ImGuiConfigFlags_NavEnableGamepad) && s_currWindowCtx->joystickId != NULL_JOYSTICK_ID &&
+        !replaying)
+    {
+        updateJoystickButtonState(io);
+        updateJoystickDPadState(io);
+        updateJoystickAxisState(io);
+    }
+
+    const TraceScope newFrameTraceScope(TracePhase::NewFrame);
+    ImGui::NewFrame();
+}
+
+void Render(sf::RenderWindow& window)
+{
+    SetCurrentWindow(window);
+    Render(static_cast<sf::RenderTarget&>(window));
+}
+
+void Render(sf::RenderTarget& target)
+{
+    target.pushGLStates();
+    s_currRenderTarget = &target;
+    Render();
+    s_currRenderTarget = nullptr;
+    target.popGLStates();
+}
+
+void Render()
+{
+    {
+        const TraceScope traceScope(TracePhase::Render);
+
+        // the software cursor is drawn where the mouse is expected to be when the frame is presented,
+        // widgets were already built from the sampled position
+        ImGuiIO&     io         = ImGui::GetIO();
+        const ImVec2 sampledPos = io.MousePos;
+        if (s_currWindowCtx)
+        {
+            if (const std::optional<sf::Vector2f> predictedPos = predictCursorPosition(s_currWindowCtx->pacer))
+                io.MousePos = toImVec2(*predictedPos);
+        }
+        ImGui::Render();
+        io.MousePos = sampledPos;
+    }
+    RenderDrawLists(ImGui::GetDrawData());
+
+    if (s_currWindowCtx && s_currWindowCtx->pacer.settings)
+        s_currWindowCtx->pacer.renderEnd = s_pacingClock.getElapsedTime();
+}
+
+void Shutdown(const sf::Window& window)
+{
+    const bool needReplacement = (s_currWindowCtx->window->getNativeHandle() == window.getNativeHandle());
+
+    // remove window's context
+    auto found = std::find_if(s_windowContexts.begin(),
+                              s_windowContexts.end(),
+                              [&](std::unique_ptr<WindowContext>& ctx)
+                              { return ctx->window->getNativeHandle() == window.getNativeHandle(); });
+    assert(found != s_windowContexts.end() &&
+           "Window wasn't inited properly: forgot to call ImGui::SFML::Init(window)?");
+    if (s_contextPool.size() < s_maxPooledContexts)
+    {
+        rebindWindowContext(**found, nullptr);
+        s_contextPool.push_back(std::move(*found));
+    }
+    else
+    {
+        releaseWindowGpuTimer(**found);
+    }
+    s_windowContexts.erase(found); // s_currWindowCtx can become invalid here!
+    if (s_windowContexts.empty())
+        releaseAtlasPages(); // copied again from the registered textures if a window is inited later
+
+    // set current context to some window for convenience if needed
+    if (needReplacement)
+    {
+        auto it = s_windowContexts.begin();
+        if (it != s_windowContexts.end())
+        {
+            // set to some other window
+            setCurrentWindowContext(it->get());
+        }
+        else
+        {
+            // no alternatives...
+            setCurrentWindowContext(nullptr);
+        }
+    }
+}
+
+void Shutdown()
+{
+    setCurrentWindowContext(nullptr);
+
+    for (const std::unique_ptr<WindowContext>& ctx : s_windowContexts)
+        releaseWindowGpuTimer(*ctx);
+    s_windowContexts.clear();
+    s_contextPool.clear();
+    releaseAtlasPages();
+    DisableAsyncImages();
+    ClearViewportPool();
+#ifdef IMGUI_SFML_SHADER_RENDERER
+    destroyShaderRenderer();
+#endif
+}
+
+bool UpdateFontTexture()
+{
+    assert(s_currWindowCtx);
+    const TraceScope traceScope(TracePhase::UpdateFontTexture);
+
+    // scaled atlases are baked again from the updated fonts when needed
+    resetFontAtlases(s_currWindowCtx->dpi);
+
+    ImGuiIO&       io     = ImGui::GetIO();
+    unsigned char* pixels = nullptr;
+    int            width  = 0;
+    int            height = 0;
+
+    if (const std::optional<SdfFontState>& sdf = s_currWindowCtx->sdf)
+    {
+        // rebuilt so that the distance field is computed from the glyphs' coverage only once
+        io.Fonts->ClearTexData();
+        io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+        const std::size_t pitch = static_cast<std::size_t>(width);
+        convertToDistanceField(pixels, pitch, static_cast<std::size_t>(height), sdf->settings.spread);
+
+        // solid shapes sample the white pixel, which must stay fully inside
+        const ImVec2 whitePixel(io.Fonts->TexUvWhitePixel.x * static_cast<float>(width),
+                                io.Fonts->TexUvWhitePixel.y * static_cast<float>(height));
+        pixels[static_cast<std::size_t>(whitePixel.y) * pitch + static_cast<std::size_t>(whitePixel.x)] = 255;
+    }
+
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    // reuse the existing texture when the atlas size didn't change, e.g. after adding glyphs
+    std::optional<sf::Texture>& fontTexture = s_currWindowCtx->fontTexture;
+    const sf::Vector2u          size(sf::Vector2(width, height));
+    if (!fontTexture || fontTexture->getSize() != size)
+    {
+        sf::Texture newTexture;
+        if (!newTexture.resize(size))
+        {
+            return false;
+        }
+        fontTexture = std::move(newTexture);
+    }
+
+    fontTexture->update(pixels);
+    fontTexture->setSmooth(s_currWindowCtx->sdf.has_value()); // distance fields are interpolated
+
+    ImTextureID texID = convertGLTextureHandleToImTextureID(fontTexture->getNativeHandle());
+    io.Fonts->SetTexID(texID);
+
+    return true;
+}
+
+std::optional<sf::Texture>& GetFontTexture()
+{
+    assert(s_currWindowCtx);
+    return s_currWindowCtx->fontTexture;
+}
+
+void RegisterTexture(const sf::Texture& texture)
+{
+    if (s_textureRegistry.indices.count(&texture) != 0)
+        return;
+
+    std::uint32_t index = 0;
+    if (!s_textureRegistry.freeIndices.empty())
+    {
+        index = s_textureRegistry.freeIndices.back();
+        s_textureRegistry.freeIndices.pop_back();
+    }
+    else
+    {
+        assert(s_textureRegistry.entries.size() <= TextureIndexMask && "Too many registered textures");
+        index = static_cast<std::uint32_t>(s_textureRegistry.entries.size());
+        s_textureRegistry.entries.emplace_back();
+    }
+
+    RegisteredTexture& entry = s_textureRegistry.entries[index];
+    entry.texture            = &texture;
+    entry.nativeHandle       = texture.getNativeHandle();
+    entry.sampler.reset();
+    entry.atlasSlot.reset();
+    s_textureRegistry.indices.emplace(&texture, index);
+}
+
+void RegisterTexture(const sf::Texture& texture, const TextureSampler& sampler)
+{
+    RegisterTexture(texture);
+    s_textureRegistry.entries[s_textureRegistry.indices[&texture]].sampler = sampler;
+}
+
+void UnregisterTexture(const sf::Texture& texture)
+{
+    const auto found = s_textureRegistry.indices.find(&texture);
+    assert(found != s_textureRegistry.indices.end() && "Texture wasn't registered");
+    if (found == s_textureRegistry.indices.end())
+        return;
+
+    RegisteredTexture& entry = s_textureRegistry.entries[found->second];
+    entry.texture            = nullptr;
+    entry.nativeHandle       = 0;
+    entry.generation         = (entry.generation + 1) & TextureGenerationMask; // invalidates ids in flight
+    entry.sampler.reset();
+    entry.atlasSlot.reset();
+
+    s_textureRegistry.freeIndices.push_back(found->second);
+    s_textureRegistry.indices.erase(found);
+}
+
+void EnableImageAtlas(const ImageAtlasSettings& settings)
+{
+    assert(settings.pageSize > 0 && settings.maxPages > 0);
+    DisableImageAtlas();
+    s_imageAtlas.settings = settings;
+}
+
+void DisableImageAtlas()
+{
+    s_imageAtlas.settings.reset();
+    releaseAtlasPages();
+}
+
+void EnableAsyncImages(const AsyncImageSettings& settings)
+{
+    assert(settings.workerThreads > 0);
+    assert((!settings.maxSize || (settings.maxSize->x > 0 && settings.maxSize->y > 0)) && "Empty maximum image size");
+    DisableAsyncImages();
+
+    s_asyncImages           = std::make_unique<AsyncImageLoader>();
+    s_asyncImages->settings = settings;
+    for (unsigned int i = 0; i < settings.workerThreads; ++i)
+        s_asyncImages->workers.emplace_back(decodeAsyncImages, std::ref(*s_asyncImages));
+}
+
+void DisableAsyncImages()
+{
+    if (!s_asyncImages)
+        return;
+
+    {
+        const std::lock_guard lock(s_asyncImages->mutex);
+        s_asyncImages->stopping = true;
+    }
+    s_asyncImages->jobAdded.notify_all();
+    for (std::thread& worker : s_asyncImages->workers)
+        worker.join();
+
+    for (AsyncImageEntry& entry : s_asyncImages->entries)
+    {
+        if (entry.texture)
+            releaseAsyncImageTexture(entry);
+    }
+    s_asyncImages.reset();
+}
+
+AsyncImage GetAsyncImage(const std::filesystem::path& path)
+{
+    assert(s_asyncImages && "Asynchronous images aren't enabled");
+
+    std::vector<AsyncImageEntry>& entries = s_asyncImages->entries;
+    const auto [found, inserted] = s_asyncImages->ids.try_emplace(path.native(),
+                                                                  static_cast<std::uint32_t>(entries.size() + 1));
+    if (inserted)
+        entries.emplace_back().path = path;
+    return AsyncImage{found->second};
+}
+
+AsyncImageState GetAsyncImageState(AsyncImage image)
+{
+    const AsyncImageEntry* entry = findAsyncImage(image);
+    return entry ? entry->state : AsyncImageState::Unloaded;
+}
+
+const sf::Texture* GetAsyncImageTexture(AsyncImage image)
+{
+    const AsyncImageEntry* entry = findAsyncImage(image);
+    return entry ? entry->texture.get() : nullptr;
+}
+
+void SetGpuTimerEnabled(bool enabled)
+{
+    assert(s_currWindowCtx);
+    s_currWindowCtx->gpuTimer.enabled = enabled;
+    if (!enabled)
+        s_currWindowCtx->gpuTimer.lastResult.reset();
+}
+
+std::optional<sf::Time> GetGpuRenderTime()
+{
+    assert(s_currWindowCtx);
+    return s_currWindowCtx->gpuTimer.lastResult;
+}
+
+void StartInputRecording(std::ostream& out)
+{
+    assert(s_currWindowCtx);
+    out.write(InputRecordingMagic, sizeof(InputRecordingMagic));
+    writeLE(out, InputRecordingVersion);
+    // focus changes are recorded as events, only the initial state is needed
+    writeLE(out, std::uint8_t{s_currWindowCtx->windowHasFocus});
+    s_currWindowCtx->inputRecording = &out;
+}
+
+void StopInputRecording()
+{
+    assert(s_currWindowCtx);
+    if (s_currWindowCtx->inputRecording)
+        s_currWindowCtx->inputRecording->flush();
+    s_currWindowCtx->inputRecording = nullptr;
+}
+
+std::optional<std::size_t> ReplayInput(const sf::Window& window,
+                                       std::istream&     in,
+                                       ReplayFrameFn     buildFrame,
+                                       void*             userData,
+                                       sf::RenderTarget* target)
+{
+    SetCurrentWindow(window);
+    WindowContext* const ctx = s_currWindowCtx;
+
+    char         magic[sizeof(InputRecordingMagic)] = {};
+    std::uint8_t version                            = 0;
+    std::uint8_t recordedFocus                      = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, InputRecordingMagic, sizeof(magic)) != 0 ||
+        !readLE(in, version) || version != InputRecordingVersion || !readLE(in, recordedFocus))
+    {
+        return std::nullopt;
+    }
+
+    // events are only handled while focused, so the replay starts with the focus of the recording
+    const bool windowHadFocus = ctx->windowHasFocus;
+    ctx->windowHasFocus       = recordedFocus != 0;
+    ImGui::GetIO().AddFocusEvent(ctx->windowHasFocus);
+    ctx->replaying = true;
+
+    std::size_t  frames     = 0;
+    bool         valid      = true;
+    std::uint8_t recordType = 0;
+    while (valid && readLE(in, recordType))
+    {
+        if (recordType == static_cast<std::uint8_t>(InputRecordType::Event))
+        {
+            // a recording cut short ends the replay, as if the stream ended there
+            const std::optional<sf::Event> event = readRecordedEvent(in);
+            if (!event)
+                break;
+            ProcessEvent(window, *event);
+        }
+        else if (recordType == static_cast<std::uint8_t>(InputRecordType::Update))
+        {
+            std::uint64_t dt = 0;
+            sf::Vector2i  mousePos;
+            sf::Vector2f  displaySize;
+            if (!readLE(in, dt) || !readVector2i(in, mousePos) || !readF32(in, displaySize.x) ||
+                !readF32(in, displaySize.y) || !readLE(in, ctx->replayMouseDown))
+                break;
+
+            SetCurrentWindow(window);
+            Update(mousePos, displaySize, sf::microseconds(static_cast<std::int64_t>(dt)));
+            if (buildFrame)
+                buildFrame(userData);
+
+            SetCurrentWindow(window);
+            if (target)
+                Render(*target);
+            else
+                ImGui::Render();
+            ++frames;
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+    ctx->replaying = false;
+    SetCurrentWindow(window);
+    ctx->windowHasFocus = windowHadFocus;
+    ImGui::GetIO().AddFocusEvent(windowHadFocus);
+
+    return valid ? std::optional(frames) : std::nullopt;
+}
+
+void EnableLowLatencyMode(const LowLatencySettings& settings)
+{
+    assert(s_currWindowCtx);
+    s_currWindowCtx->pacer          = FramePacer{};
+    s_currWindowCtx->pacer.settings = settings;
+}
+
+void DisableLowLatencyMode()
+{
+    assert(s_currWindowCtx);
+    s_currWindowCtx->pacer = FramePacer{};
+}
+
+void WaitForInputDeadline()
+{
+    assert(s_currWindowCtx);
+    FramePacer& pacer = s_currWindowCtx->pacer;
+    if (!pacer.settings)
+        return;
+
+    if (pacer.lastPresent && pacer.framePeriod > sf::Time::Zero)
+    {
+        // wake up as late as possible while still making the next vsync
+        const sf::Time deadline = *pacer.lastPresent + pacer.framePeriod - pacer.workEstimate -
+                                  pacer.settings->safetyMargin;
+        const sf::Time now      = s_pacingClock.getElapsedTime();
+        if (deadline > now)
+            sf::sleep(deadline - now);
+    }
+    pacer.wakeTime = s_pacingClock.getElapsedTime();
+}
+
+void MarkFramePresented()
+{
+    assert(s_currWindowCtx);
+    FramePacer& pacer = s_currWindowCtx->pacer;
+    if (!pacer.settings)
+        return;
+
+    const sf::Time now = s_pacingClock.getElapsedTime();
+    if (pacer.lastPresent)
+    {
+        // intervals of missed vsyncs aren't a frame period
+        const sf::Time interval = now - *pacer.lastPresent;
+        if (pacer.framePeriod == sf::Time::Zero)
+            pacer.framePeriod = interval;
+        else if (interval < pacer.framePeriod * 1.5f)
+            pacer.framePeriod += (interval - pacer.framePeriod) * 0.1f;
+    }
+    pacer.lastPresent = now;
+
+    const std::optional<sf::Time> workBegin = pacer.wakeTime ? pacer.wakeTime : pacer.sampleTime;
+    if (workBegin && pacer.renderEnd)
+    {
+        // rises immediately, decays slowly so that a single fast frame doesn't cause a missed vsync
+        const sf::Time work = *pacer.renderEnd - *workBegin;
+        pacer.workEstimate  = std::max(work, pacer.workEstimate - (pacer.workEstimate - work) * 0.05f);
+    }
+
+    pacer.lastLatency.reset();
+    if (pacer.sampleTime)
+    {
+        pacer.lastLatency     = now - *pacer.sampleTime;
+        pacer.latencyEstimate = pacer.latencyEstimate == sf::Time::Zero
+                                    ? *pacer.lastLatency
+                                    : pacer.latencyEstimate + (*pacer.lastLatency - pacer.latencyEstimate) * 0.1f;
+    }
+
+    pacer.wakeTime.reset();
+    pacer.sampleTime.reset();
+    pacer.renderEnd.reset();
+}
+
+std::optional<sf::Time> GetInputToPresentLatency()
+{
+    assert(s_currWindowCtx);
+    return s_currWindowCtx->pacer.lastLatency;
+}
+
+void SetBufferUploadStrategy(BufferUploadStrategy strategy)
+{
+    s_bufferUpload.requested = strategy;
+}
+
+BufferUploadStrategy GetBufferUploadStrategy()
+{
+    return s_bufferUpload.effective;
+}
+
+void EnableGeometryCache(const GeometryCacheSettings& settings)
+{
+    s_geometryCacheSettings = settings;
+}
+
+void DisableGeometryCache()
+{
+    // the cached buffers are released by the next render, when a context is active
+    s_geometryCacheSettings.reset();
+    s_geometryCacheStats = GeometryCacheStats{};
+}
+
+GeometryCacheStats GetGeometryCacheStats()
+{
+    return s_geometryCacheStats;
+}
+
+bool EnableSdfFonts(const SdfFontSettings& settings)
+{
+    assert(s_currWindowCtx);
+    assert(settings.spread > 0.f);
+#ifdef IMGUI_SFML_SHADER_RENDERER
+    if (!hasDistanceFieldProgram())
+        return false;
+#else
+    if (!sf::Shader::isAvailable())
+        return false;
+
+    sf::Shader shader;
+    if (!shader.loadFromMemory(sdfVertexShader, sdfFragmentShader))
+        return false;
+    shader.setUniform("texture", sf::Shader::CurrentTexture);
+#endif
+
+    resetFontAtlases(s_currWindowCtx->dpi); // the distance field is baked into the base atlas
+    ImFontAtlas& fonts = *ImGui::GetIO().Fonts;
+    if (!s_currWindowCtx->sdf)
+    {
+        SdfFontState& sdf        = s_currWindowCtx->sdf.emplace();
+        sdf.previousGlyphPadding = fonts.TexGlyphPadding;
+        sdf.previousFlags        = fonts.Flags;
+    }
+    s_currWindowCtx->sdf->settings = settings;
+#ifndef IMGUI_SFML_SHADER_RENDERER
+    s_currWindowCtx->sdf->shader = std::move(shader);
+#endif
+
+    // the distance field needs room around the glyphs, and lines are drawn without the atlas
+    const int padding     = static_cast<int>(std::ceil(settings.spread));
+    fonts.TexGlyphPadding = std::max(s_currWindowCtx->sdf->previousGlyphPadding, padding);
+    fonts.Flags |= ImFontAtlasFlags_NoBakedLines;
+    return UpdateFontTexture();
+}
+
+bool DisableSdfFonts()
+{
+    assert(s_currWindowCtx);
+    if (!s_currWindowCtx->sdf)
+        return true;
+
+    resetFontAtlases(s_currWindowCtx->dpi);
+    ImFontAtlas& fonts    = *ImGui::GetIO().Fonts;
+    fonts.TexGlyphPadding = s_currWindowCtx->sdf->previousGlyphPadding;
+    fonts.Flags           = s_currWindowCtx->sdf->previousFlags;
+    s_currWindowCtx->sdf.reset();
+
+    fonts.ClearTexData(); // baked again as coverage
+    return UpdateFontTexture();
+}
+
+void EnableDpiScaling(const DpiSettings& settings)
+{
+    assert(s_currWindowCtx);
+    s_currWindowCtx->dpi.settings = settings;
+}
+
+void SetDpiContentScale(float contentScale)
+{
+    assert(s_currWindowCtx);
+    assert(contentScale > 0.f);
+    s_currWindowCtx->dpi.contentScale = contentScale;
+}
+
+void DisableDpiScaling()
+{
+    assert(s_currWindowCtx);
+    DpiState& dpi = s_currWindowCtx->dpi;
+    resetFontAtlases(dpi);
+    dpi.settings.reset();
+    ImGui::GetIO().DisplayFramebufferScale = ImVec2(1.f, 1.f);
+}
+
+void SetContextPoolSize(std::size_t maxPooledContexts)
+{
+    s_maxPooledContexts = maxPooledContexts;
+    if (s_contextPool.size() > maxPooledContexts)
+    {
+        // release the contexts which were pooled first
+        const auto excess = static_cast<std::ptrdiff_t>(s_contextPool.size() - maxPooledContexts);
+        s_contextPool.erase(s_contextPool.begin(), s_contextPool.begin() + excess);
+    }
+}
+
+MemoryReport GetMemoryReport()
+{
+    MemoryReport report;
+
+    WindowContext* const previousCtx = s_currWindowCtx;
+    for (const std::unique_ptr<WindowContext>& ctx : s_windowContexts)
+    {
+        setCurrentWindowContext(ctx.get());
+        ContextMemoryReport& contextReport = report.contexts.emplace_back();
+        contextReport.window               = ctx->window->getNativeHandle();
+
+        if (ctx->fontTexture)
+        {
+            const sf::Vector2u size        = ctx->fontTexture->getSize();
+            contextReport.fontTextureBytes = std::size_t{size.x} * size.y * 4;
+        }
+        for (const ScaledFontAtlas& scaled : ctx->dpi.atlases)
+        {
+            const sf::Vector2u size = scaled.texture.getSize();
+            contextReport.fontTextureBytes += std::size_t{size.x} * size.y * 4;
+        }
+
+        const ImFontAtlas& fonts     = *ImGui::GetIO().Fonts;
+        const auto         texPixels = static_cast<std::size_t>(fonts.TexWidth) * static_cast<std::size_t>(fonts.TexHeight);
+        contextReport.fontPixelBytes = (fonts.TexPixelsAlpha8 ? texPixels : 0) + (fonts.TexPixelsRGBA32 ? texPixels * 4 : 0);
+
+        if (const ImDrawData* drawData = ImGui::GetDrawData())
+        {
+            for (const ImDrawList* drawList : drawData->CmdLists)
+            {
+                ++contextReport.drawListCount;
+                contextReport.drawBufferBytes += getCapacityBytes(drawList->VtxBuffer) +
+                                                 getCapacityBytes(drawList->IdxBuffer) +
+                                                 getCapacityBytes(drawList->CmdBuffer);
+                contextReport.drawBufferUsedBytes += static_cast<std::size_t>(drawList->VtxBuffer.size_in_bytes()) +
+                                                     static_cast<std::size_t>(drawList->IdxBuffer.size_in_bytes()) +
+                                                     static_cast<std::size_t>(drawList->CmdBuffer.size_in_bytes());
+            }
+        }
+
+        contextReport.backendBufferBytes = getCapacityBytes(ctx->drawableCommands) +
+                                           getCapacityBytes(ctx->primitiveBatches) +
+                                           getCapacityBytes(ctx->primitiveInstances) +
+                                           ctx->drawListUsage.size() *
+                                               (sizeof(const ImDrawList*) + sizeof(DrawListUsage));
+        if (ctx->allocator)
+            contextReport.allocator = ctx->allocator->stats;
+    }
+    setCurrentWindowContext(previousCtx);
+
+    for (const std::optional<sf::Cursor>& cursor : s_cursorCache.cursors)
+        report.cursorCount += cursor.has_value() ? 1u : 0u;
+
+    for (const AtlasPage& page : s_imageAtlas.pages)
+    {
+        const sf::Vector2u size = page.texture.getSize();
+        report.atlasTextureBytes += std::size_t{size.x} * size.y * 4;
+    }
+    for (const std::unique_ptr<PooledRenderTexture>& pooled : s_renderTexturePool.textures)
+    {
+        const sf::Vector2u size = pooled->texture.getSize();
+        report.viewportTextureBytes += std::size_t{size.x} * size.y * 4;
+    }
+    if (s_asyncImages)
+    {
+        for (const AsyncImageEntry& entry : s_asyncImages->entries)
+        {
+            if (!entry.texture)
+                continue;
+            const sf::Vector2u size = entry.texture->getSize();
+            report.asyncImageTextureBytes += std::size_t{size.x} * size.y * 4;
+        }
+    }
+    report.registeredTextureCount = s_textureRegistry.indices.size();
+
+    return report;
+}
+
+void TrimMemory(const TrimPolicy& policy)
+{
+    assert(policy.slack >= 1.f);
+    assert(!s_renderTexturePool.current && "TrimMemory must be called between frames");
+
+    WindowContext* const previousCtx = s_currWindowCtx;
+    for (const std::unique_ptr<WindowContext>& ctx : s_windowContexts)
+    {
+        // buffers are reallocated with the context's own allocator
+        setCurrentWindowContext(ctx.get());
+
+        if (ImDrawData* drawData = ImGui::GetDrawData())
+        {
+            for (ImDrawList* drawList : drawData->CmdLists)
+            {
+                const auto found = ctx->drawListUsage.find(drawList);
+                if (found == ctx->drawListUsage.end() ||
+                    found->second.sinceFrame + policy.oversizedFrames > s_frameCounter)
+                    continue;
+
+                DrawListUsage& usage = found->second;
+                shrinkImVector(drawList->VtxBuffer, usage.peakVtxCount, policy.slack);
+                shrinkImVector(drawList->IdxBuffer, usage.peakIdxCount, policy.slack);
+                shrinkImVector(drawList->CmdBuffer, usage.peakCmdCount, policy.slack);
+
+                usage = DrawListUsage{drawList->VtxBuffer.Size,
+                                      drawList->IdxBuffer.Size,
+                                      drawList->CmdBuffer.Size,
+                                      s_frameCounter,
+                                      usage.lastSeenFrame};
+            }
+        }
+
+        // forget draw lists which are no longer rendered, their address may be reused
+        for (auto it = ctx->drawListUsage.begin(); it != ctx->drawListUsage.end();)
+        {
+            if (it->second.lastSeenFrame + policy.oversizedFrames < s_frameCounter)
+                it = ctx->drawListUsage.erase(it);
+            else
+                ++it;
+        }
+
+        if (ctx->drawableCommands.empty())
+            ctx->drawableCommands.shrink_to_fit();
+        if (ctx->primitiveInstances.empty())
+        {
+            ctx->primitiveBatches.shrink_to_fit();
+            ctx->primitiveInstances.shrink_to_fit();
+        }
+
+        // atlases of the scales the window isn't displayed at are baked again when needed
+        if (policy.releaseGpuCaches)
+        {
+            DpiState& dpi = ctx->dpi;
+            dpi.atlases.erase(std::remove_if(dpi.atlases.begin(),
+                                             dpi.atlases.end(),
+                                             [&dpi](const ScaledFontAtlas& atlas)
+                                             { return atlas.scale != dpi.currentScale; }),
+                              dpi.atlases.end());
+        }
+
+        // rebuilt from the fonts' source data by UpdateFontTexture if needed
+        if (policy.releaseFontPixels)
+            ImGui::GetIO().Fonts->ClearTexData();
+    }
+    setCurrentWindowContext(previousCtx);
+
+    if (policy.releaseGpuCaches)
+    {
+        releaseAtlasPages();
+        ClearViewportPool();
+        if (s_asyncImages)
+        {
+            // loaded again the next time they're visible
+            for (AsyncImageEntry& entry : s_asyncImages->entries)
+            {
+                if (entry.texture && !mayBeInFlight(entry.lastVisibleFrame))
+                    releaseAsyncImageTexture(entry);
+            }
+        }
+#ifdef IMGUI_SFML_SHADER_RENDERER
+        clearGeometryCache(); // static draw lists are cached again after a few frames
+#endif
+    }
+}
+
+std::optional<AllocatorStats> GetAllocatorStats()
+{
+    assert(s_currWindowCtx);
+    if (!s_currWindowCtx->allocator)
+        return std::nullopt;
+    return s_currWindowCtx->allocator->stats;
+}
+
+void SetTracingEnabled(bool enabled)
+{
+    if (enabled && !s_tracing.slots)
+        s_tracing.slots = std::make_unique<TraceSlot[]>(TraceState::Capacity);
+    s_tracing.enabled.store(enabled, std::memory_order_release); // publishes the slots
+}
+
+void SetTraceSink(TraceSink sink, void* userData)
+{
+    s_tracing.sink         = sink;
+    s_tracing.sinkUserData = userData;
+}
+
+const char* GetTracePhaseName(TracePhase phase)
+{
+    switch (phase)
+    {
+        case TracePhase::ProcessEvents:
+            return "ProcessEvents";
+        case TracePhase::Update:
+            return "Update";
+        case TracePhase::NewFrame:
+            return "NewFrame";
+        case TracePhase::Render:
+            return "Render";
+        case TracePhase::UpdateFontTexture:
+            return "UpdateFontTexture";
+        case TracePhase::RenderDrawLists:
+            return "RenderDrawLists";
+    }
+    return "";
+}
+
+std::size_t FlushChromeTrace(std::ostream& out)
+{
+    std::size_t written = 0;
+    out << "{\"traceEvents\":[";
+
+    // the slots are allocated before the first event is published
+    const std::uint64_t end = s_tracing.writeIndex.load(std::memory_order_acquire);
+    if (end > 0)
+    {
+        // events older than the ring capacity have been overwritten already
+        std::uint64_t index = std::max(s_tracing.readIndex, end > TraceState::Capacity ? end - TraceState::Capacity : 0);
+
+        for (; index < end; ++index)
+        {
+            const TraceSlot&    slot     = s_tracing.slots[index % TraceState::Capacity];
+            const std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto          phase    = static_cast<TracePhase>(slot.phase.load(std::memory_order_relaxed));
+            const std::uint64_t windowId = slot.windowId.load(std::memory_order_relaxed);
+            const std::int64_t  beginUs  = slot.begin.load(std::memory_order_relaxed);
+            const std::int64_t  endUs    = slot.end.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence != 2 * (index + 1) || slot.sequence.load(std::memory_order_relaxed) != sequence)
+                continue; // overwritten while we were reading it
+
+            out << (written == 0 ? "" : ",") << "\n{\"name\":\"" << GetTracePhaseName(phase)
+                << "\",\"cat\":\"imgui-sfml\",\"ph\":\"X\",\"pid\":0,\"tid\":" << windowId << ",\"ts\":" << beginUs
+                << ",\"dur\":" << endUs - beginUs << "}";
+            ++written;
+        }
+        s_tracing.readIndex = end;
+    }
+
+    out << "\n]}\n";
+    return written;
+}
+
+void DrawDrawable(const sf::Drawable& drawable, const sf::RenderStates& states, const sf::Vector2f& size)
+{
+    DrawDrawable(drawable, states, size, sf::View(sf::FloatRect({0.f, 0.f}, size)));
+}
+
+void DrawDrawable(const sf::Drawable& drawable, const sf::RenderStates& states, const sf::Vector2f& size, const sf::View& view)
+{
+    assert(s_currWindowCtx);
+
+    const sf::Vector2f position = toSfVector2f(ImGui::GetCursorScreenPos());
+    ImGui::Dummy(toImVec2(size));
+    if (!ImGui::IsItemVisible())
+        return;
+
+    std::vector<DrawableCommand>& commands = s_currWindowCtx->drawableCommands;
+    commands.push_back({&drawable, states, view, sf::FloatRect(position, size)});
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    drawList->AddCallback(drawDrawableCallback, reinterpret_cast<void*>(static_cast<std::uintptr_t>(commands.size() - 1)));
+    drawList->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+}
+
+sf::RenderTexture* BeginViewport(const char* id, const sf::Vector2f& size, const ViewportSettings& settings)
+{
+    assert(s_currWindowCtx);
+    assert(!s_renderTexturePool.current && "BeginViewport can't be nested: forgot to call EndViewport?");
+    assert(settings.minResolutionScale > 0.f && settings.minResolutionScale <= 1.f);
+    s_renderTexturePool.skipped = true; // until a texture is returned
+
+    ViewportState& viewport = getViewportState(ImGui::GetID(id));
+    viewport.size           = size;
+    viewport.lastUsedFrame  = s_frameCounter;
+
+    viewport.gpuTimer.enabled = settings.gpuBudget.has_value();
+    if (!settings.gpuBudget)
+    {
+        viewport.resolutionScale = 1.f;
+    }
+    else if (viewport.gpuTimer.lastResult)
+    {
+        // cost is roughly proportional to the pixel count, so to the square of the scale
+        const float ratio = settings.gpuBudget->asSeconds() / std::max(viewport.gpuTimer.lastResult->asSeconds(), 1e-6f);
+        viewport.resolutionScale = std::clamp(viewport.resolutionScale * std::clamp(std::sqrt(ratio), 0.9f, 1.05f),
+                                              settings.minResolutionScale,
+                                              1.f);
+        viewport.gpuTimer.lastResult.reset();
+    }
+
+    const sf::Vector2f scaledSize = size * viewport.resolutionScale;
+    if (scaledSize.x < 1.f || scaledSize.y < 1.f)
+    {
+        ImGui::Dummy(toImVec2(size));
+        return nullptr;
+    }
+
+    viewport.pixelSize = sf::Vector2u(sf::Vector2f(std::round(scaledSize.x), std::round(scaledSize.y)));
+    viewport.target    = acquireRenderTexture(viewport.pixelSize, viewport.target);
+    if (!viewport.target)
+    {
+        ImGui::Dummy(toImVec2(size));
+        return nullptr;
+    }
+
+    // only the top-left part of a pooled texture is used
+    sf::RenderTexture& texture = viewport.target->texture;
+    sf::View           view(sf::FloatRect({0.f, 0.f}, size));
+    view.setViewport(
+        sf::FloatRect({0.f, 0.f}, sf::Vector2f(viewport.pixelSize).componentWiseDiv(sf::Vector2f(texture.getSize()))));
+    texture.setView(view);
+
+    viewport.gpuTimerStarted = viewport.gpuTimer.enabled && texture.setActive() && beginGpuTimer(viewport.gpuTimer);
+
+    s_renderTexturePool.current = &viewport;
+    s_renderTexturePool.skipped = false;
+    return &texture;
+}
+
+void EndViewport()
+{
+    if (std::exchange(s_renderTexturePool.skipped, false))
+        return; // BeginViewport returned nullptr
+
+    assert(s_renderTexturePool.current && "EndViewport called without a matching BeginViewport");
+    if (!s_renderTexturePool.current)
+        return;
+
+    ViewportState& viewport     = *s_renderTexturePool.current;
+    s_renderTexturePool.current = nullptr;
+
+    sf::RenderTexture& texture = viewport.target->texture;
+    if (viewport.gpuTimerStarted && texture.setActive())
+        endGpuTimer(viewport.gpuTimer);
+    texture.display();
+
+    // render textures are upside down, the used part is at the top of the GL texture
+    const sf::Vector2f used = sf::Vector2f(viewport.pixelSize).componentWiseDiv(sf::Vector2f(texture.getSize()));
+    ImGui::Image(getTextureID(texture.getTexture()), toImVec2(viewport.size), ImVec2(0.f, 1.f), ImVec2(used.x, 1.f - used.y));
+}
+
+void ClearViewportPool()
+{
+    assert(!s_renderTexturePool.current);
+    for (const std::unique_ptr<ViewportState>& viewport : s_renderTexturePool.viewports)
+        releaseViewportGpuTimer(*viewport);
+    s_renderTexturePool.viewports.clear();
+    s_renderTexturePool.textures.clear();
+}
+
+void SetActiveJoystickId(unsigned int joystickId)
+{
+    assert(s_currWindowCtx);
+    assert(joystickId < sf::Joystick::Count);
+    s_currWindowCtx->joystickId = joystickId;
+}
+
+void SetJoystickDPadThreshold(float threshold)
+{
+    assert(s_currWindowCtx);
+    assert(threshold >= 0.f && threshold <= 100.f);
+    s_currWindowCtx->dPadInfo.threshold = threshold;
+}
+
+void SetJoystickLStickThreshold(float threshold)
+{
+    assert(s_currWindowCtx);
+    assert(threshold >= 0.f && threshold <= 100.f);
+    s_currWindowCtx->lStickInfo.threshold = threshold;
+}
+
+void SetJoystickRStickThreshold(float threshold)
+{
+    assert(s_currWindowCtx);
+    assert(threshold >= 0.f && threshold <= 100.f);
+    s_currWindowCtx->rStickInfo.threshold = threshold;
+}
+
+void SetJoystickLTriggerThreshold(float threshold)
+{
+    assert(s_currWindowCtx);
+    assert(threshold >= -100.f && threshold <= 100.f);
+    s_currWindowCtx->lTriggerInfo.threshold = threshold;
+}
+
+void SetJoystickRTriggerThreshold(float threshold)
+{
+    assert(s_currWindowCtx);
+    assert(threshold >= -100.f && threshold <= 100.f);
+    s_currWindowCtx->rTriggerInfo.threshold = threshold;
+}
+
+void SetJoystickMapping(int key, unsigned int joystickButton)
+{
+    assert(s_currWindowCtx);
+    assert(key >= ImGuiKey_NamedKey_BEGIN);
+    assert(key < ImGuiKey_NamedKey_END);
+    assert(joystickButton < sf::Joystick::ButtonCount);
+    s_currWindowCtx->joystickMapping[joystickButton] = static_cast<ImGuiKey>(key);
+}
+
+void SetDPadXAxis(sf::Joystick::Axis dPadXAxis, bool inverted)
+{
+    assert(s_currWindowCtx);
+    s_currWindowCtx->dPadInfo.xAxis     = dPadXAxis;
+    s_currWindowCtx->dPadInfo.xInverted = inverted;
+}
+
+void SetDPadYAxis(sf::Joystick::Axis dPadYAxis, bool inverted)
+{
+    assert(s_currWindowCtx);
+    s_currWindowCtx->dPadInfo.yAxis     = dPadYAxis;
+    s_currWindowCtx->dPadInfo.yInverted = inverted;
+}
+
+void SetLStickXAxis(sf::Joystick::Axis lStickXAxis, bool inverted)
+{
+    assert(s_currWindowCtx);
+    s_currWindowCtx->lStickInfo.xAxis     = lStickXAxis;
+    s_currWindowCtx->lStickInfo.xInverted = inverted;
+}
+
+void SetLStickYAxis(sf::Joystick::Axis lStickYAxis, bool inverted)
+{
+    assert(s_currWindowCtx);
+    s_currWindowCtx->lStickInfo.yAxis     = lStickYAxis;
+    s_currWindowCtx->lStickInfo.yInverted = inverted;
+}
+
+void SetRStickXAxis(sf::Joystick::Axis rStickXAxis, bool inverted)
+{
+    assert(s_currWindowCtx);
+    s_currWindowCtx->rStickInfo.xAxis     = rStickXAxis;
+    s_currWindowCtx->rStickInfo.xInverted = inverted;
+}
+
+void SetRStickYAxis(sf::Joystick::Axis rStickYAxis, bool inverted)
+{
+    assert(s_currWindowCtx);
+    s_currWindowCtx->rStickInfo.yAxis     = rStickYAxis;
+    s_currWindowCtx->rStickInfo.yInverted = inverted;
+}
+
+void SetLTriggerAxis(sf::Joystick::Axis lTriggerAxis)
+{
+    assert(s_currWindowCtx);
+    s_currWindowCtx->lTriggerInfo.axis = lTriggerAxis;
+}
+
+void SetRTriggerAxis(sf::Joystick::Axis rTriggerAxis)
+{
+    assert(s_currWindowCtx);
+    s_currWindowCtx->rTriggerInfo.axis = rTriggerAxis;
+}
+
+} // end of namespace SFML
+
+/////////////// Image Overloads for sf::Texture
+
+void Image(const sf::Texture& texture, const sf::Color& tintColor, const sf::Color& borderColor)
+{
+    Image(texture, sf::Vector2f(texture.getSize()), tintColor, borderColor);
+}
+
+void Image(const sf::Texture& texture, const sf::Vector2f& size, const sf::Color& tintColor, const sf::Color& borderColor)
+{
+    auto [uv0, uv1, textureID] = getTextureData(texture);
+    ImGui::Image(textureID, toImVec2(size), uv0, uv1, toImColor(tintColor), toImColor(borderColor));
+}
+
+/////////////// Image Overloads for sf::RenderTexture
+void Image(const sf::RenderTexture& texture, const sf::Color& tintColor, const sf::Color& borderColor)
+{
+    Image(texture, sf::Vector2f(texture.getSize()), tintColor, borderColor);
+}
+
+void Image(const sf::RenderTexture& texture, const sf::Vector2f& size, const sf::Color& tintColor, const sf::Color& borderColor)
+{
+    ImTextureID textureID = getTextureID(texture.getTexture());
+
+    ImGui::Image(textureID,
+                 toImVec2(size),
+                 ImVec2(0, 1),
+                 ImVec2(1, 0), // flipped vertically,
+                               // because textures in
+                               // sf::RenderTexture are
+                               // stored this way
+                 toImColor(tintColor),
+                 toImColor(borderColor));
+}
+
+/////////////// Image Overloads for sf::Sprite
+
+void Image(const sf::Sprite& sprite, const sf::Color& tintColor, const sf::Color& borderColor)
+{
+    Image(sprite, sprite.getGlobalBounds().size, tintColor, borderColor);
+}
+
+void Image(const sf::Sprite& sprite, const sf::Vector2f& size, const sf::Color& tintColor, const sf::Color& borderColor)
+{
+    auto [uv0, uv1, textureID] = getSpriteTextureData(sprite);
+    ImGui::Image(textureID, toImVec2(size), uv0, uv1, toImColor(tintColor), toImColor(borderColor));
+}
+
+/////////////// Image Overloads for asynchronous images
+
+void Image(ImGui::SFML::AsyncImage image, const sf::Vector2f& size, const sf::Color& tintColor, const sf::Color& borderColor)
+{
+    auto [uv0, uv1, textureID] = getAsyncImageTextureData(image);
+    ImGui::Image(textureID, toImVec2(size), uv0, uv1, getAsyncImageTint(image, tintColor), toImColor(borderColor));
+    touchAsyncImage(image);
+}
+
+/////////////// Image Button Overloads for sf::Texture
+
+bool ImageButton(const char*         id,
+                 const sf::Texture&  texture,
+                 const sf::Vector2f& size,
+                 const sf::Color&    bgColor,
+                 const sf::Color&    tintColor)
+{
+    auto [uv0, uv1, textureID] = getTextureData(texture);
+    return ImGui::ImageButton(id, textureID, toImVec2(size), uv0, uv1, toImColor(bgColor), toImColor(tintColor));
+}
+
+/////////////// Image Button Overloads for sf::RenderTexture
+
+bool ImageButton(const char*              id,
+                 const sf::RenderTexture& texture,
+                 const sf::Vector2f&      size,
+                 const sf::Color&         bgColor,
+                 const sf::Color&         tintColor)
+{
+    ImTextureID textureID = getTextureID(texture.getTexture());
+
+    return ImGui::ImageButton(id,
+                              textureID,
+                              toImVec2(size),
+                              ImVec2(0, 1),
+                              ImVec2(1, 0), // flipped vertically, because textures in
+                                            // sf::RenderTexture are stored this way
+                              toImColor(bgColor),
+                              toImColor(tintColor));
+}
+
+/////////////// Image Button Overloads for sf::Sprite
+
+bool ImageButton(const char* id, const sf::Sprite& sprite, const sf::Vector2f& size, const sf::Color& bgColor, const sf::Color& tintColor)
+{
+    auto [uv0, uv1, textureID] = getSpriteTextureData(sprite);
+    return ImGui::ImageButton(id, textureID, toImVec2(size), uv0, uv1, toImColor(bgColor), toImColor(tintColor));
+}
+
+/////////////// Image Button Overloads for asynchronous images
+
+bool ImageButton(const char*             id,
+                 ImGui::SFML::AsyncImage image,
+                 const sf::Vector2f&     size,
+                 const sf::Color&        bgColor,
+                 const sf::Color&        tintColor)
+{
+    auto [uv0, uv1, textureID] = getAsyncImageTextureData(image);
+    const ImVec4 tint          = getAsyncImageTint(image, tintColor);
+    const bool   pressed       = ImGui::ImageButton(id, textureID, toImVec2(size), uv0, uv1, toImColor(bgColor), tint);
+    touchAsyncImage(image);
+    return pressed;
+}
+
+/////////////// Draw_list Overloads
+
+void DrawLine(const sf::Vector2f& a, const sf::Vector2f& b, const sf::Color& color, float thickness)
+{
+    ImDrawList*  draw_list = ImGui::GetWindowDrawList();
+    const ImVec2 pos       = ImGui::GetCursorScreenPos();
+    draw_list->AddLine(ImVec2(a.x + pos.x, a.y + pos.y),
+                       ImVec2(b.x + pos.x, b.y + pos.y),
+                       ColorConvertFloat4ToU32(toImColor(color)),
+                       thickness);
+}
+
+void DrawRect(const sf::FloatRect& rect, const sf::Color& color, float rounding, int rounding_corners, float thickness)
+{
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    draw_list->AddRect(getTopLeftAbsolute(rect),
+                       getDownRightAbsolute(rect),
+                       ColorConvertFloat4ToU32(toImColor(color)),
+                       rounding,
+                       rounding_corners,
+                       thickness);
+}
+
+void DrawRectFilled(const sf::FloatRect& rect, const sf::Color& color, float rounding, int rounding_corners)
+{
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    draw_list->AddRectFilled(getTopLeftAbsolute(rect),
+                             getDownRightAbsolute(rect),
+                             ColorConvertFloat4ToU32(toImColor(color)),
+                             rounding,
+                             rounding_corners);
+}
+
+/////////////// Bulk Draw_list Overloads
+
+void DrawPolyline(const sf::Vector2f* points, std::size_t count, const sf::Color& color, float thickness, bool closed)
+{
+    if (count < 2)
+        return;
+
+    ImDrawList*        drawList = ImGui::GetWindowDrawList();
+    const sf::Vector2f cursor   = toSfVector2f(ImGui::GetCursorScreenPos());
+
+    // the path buffer is kept by the draw list, so it doesn't allocate once it has grown
+    drawList->PathClear();
+    drawList->_Path.reserve(static_cast<int>(count));
+    for (const sf::Vector2f* point = points; point != points + count; ++point)
+        drawList->_Path.push_back(toImVec2(cursor + *point));
+    drawList->PathStroke(toImU32(color), closed ? ImDrawFlags_Closed : ImDrawFlags_None, thickness);
+}
+
+void DrawLines(const sf::Vector2f* points, std::size_t count, const sf::Color& color, float thickness)
+{
+    ImDrawList*        drawList  = ImGui::GetWindowDrawList();
+    const sf::Vector2f cursor    = toSfVector2f(ImGui::GetCursorScreenPos());
+    const ImVec2       uv        = ImGui::GetFontTexUvWhitePixel();
+    const ImU32        col       = toImU32(color);
+    const float        halfWidth = thickness * 0.5f;
+
+    for (std::size_t segments = count / 2; segments > 0;)
+    {
+        const std::size_t quads = reserveQuads(*drawList, segments);
+        for (const sf::Vector2f* point = points; point != points + quads * 2; point += 2)
         {
-            const int button = static_cast<int>(mouseButtonReleased->button);
-            if (button >= 0 && button < 3)
-                io.AddMouseButtonEvent(button, false);
+            writeSegmentQuad(*drawList, cursor + point[0], cursor + point[1], halfWidth, uv, col);
         }
-        else if (const auto* touchBegan = event.getIf<sf::Event::TouchBegan>())
+        points += quads * 2;
+        segments -= quads;
+    }
+}
+
+void DrawRects(const sf::FloatRect* rects, std::size_t count, const sf::Color& color, float thickness)
+{
+    ImDrawList*        drawList = ImGui::GetWindowDrawList();
+    const sf::Vector2f cursor   = toSfVector2f(ImGui::GetCursorScreenPos());
+    const ImVec2       uv       = ImGui::GetFontTexUvWhitePixel();
+    const ImU32        col      = toImU32(color);
+
+    while (count > 0)
+    {
+        const std::size_t outlines = reservePrimitives(*drawList, count, 8, 24);
+        for (const sf::FloatRect* rect = rects; rect != rects + outlines; ++rect)
         {
-            s_currWindowCtx->mouseMoved = false;
-            const unsigned int button   = touchBegan->finger;
-            if (button < 3)
-                s_currWindowCtx->touchDown[touchBegan->finger] = true;
+            const sf::Vector2f min = cursor + rect->position;
+            writeRectRing(*drawList, min, min + rect->size, thickness, uv, col);
         }
-        else if (event.is<sf::Event::TouchEnded>())
+        rects += outlines;
+        count -= outlines;
+    }
+}
+
+void DrawRectsFilled(const sf::FloatRect* rects, std::size_t count, const sf::Color& color)
+{
+    ImDrawList*        drawList = ImGui::GetWindowDrawList();
+    const sf::Vector2f cursor   = toSfVector2f(ImGui::GetCursorScreenPos());
+    const ImVec2       uv       = ImGui::GetFontTexUvWhitePixel();
+    const ImU32        col      = toImU32(color);
+
+    while (count > 0)
+    {
+        const std::size_t quads = reserveQuads(*drawList, count);
+        for (const sf::FloatRect* rect = rects; rect != rects + quads; ++rect)
         {
-            s_currWindowCtx->mouseMoved = false;
+            const sf::Vector2f min = cursor + rect->position;
+            const sf::Vector2f max = min + rect->size;
+            writeRectQuad(*drawList, min, max, uv, col);
         }
-        else if (const auto* mouseWheelScrolled = event.getIf<sf::Event::MouseWheelScrolled>())
+        rects += quads;
+        count -= quads;
+    }
+}
+
+void DrawRectsFilled(const sf::FloatRect* rects, const sf::Color* colors, std::size_t count)
+{
+    ImDrawList*        drawList = ImGui::GetWindowDrawList();
+    const sf::Vector2f cursor   = toSfVector2f(ImGui::GetCursorScreenPos());
+    const ImVec2       uv       = ImGui::GetFontTexUvWhitePixel();
+
+    while (count > 0)
+    {
+        const std::size_t quads = reserveQuads(*drawList, count);
+        for (std::size_t i = 0; i < quads; ++i)
         {
-            if (mouseWheelScrolled->wheel == sf::Mouse::Wheel::Vertical ||
-                (mouseWheelScrolled->wheel == sf::Mouse::Wheel::Horizontal && io.KeyShift))
-            {
-                io.AddMouseWheelEvent(0, mouseWheelScrolled->delta);
-            }
-            else if (mouseWheelScrolled->wheel == sf::Mouse::Wheel::Horizontal)
-            {
-                io.AddMouseWheelEvent(mouseWheelScrolled->delta, 0);
-            }
+            const sf::Vector2f min = cursor + rects[i].position;
+            const sf::Vector2f max = min + rects[i].size;
+            writeRectQuad(*drawList, min, max, uv, toImU32(colors[i]));
         }
-        const auto handleKeyChanged = [&io](const auto& keyChanged, bool down)
+        rects += quads;
+        colors += quads;
+        count -= quads;
+    }
+}
+
+void DrawPrimitiveInstances(const PrimitiveInstance* instances, std::size_t count)
+{
+    assert(s_currWindowCtx);
+    if (count == 0)
+        return;
+
+    ImDrawList*        drawList = ImGui::GetWindowDrawList();
+    const sf::Vector2f cursor   = toSfVector2f(ImGui::GetCursorScreenPos());
+
+#ifdef IMGUI_SFML_RENDERER_GLES3
+    // the draw data of this frame maps the main viewport to the framebuffer
+    const ImGuiViewport*            viewport = ImGui::GetMainViewport();
+    std::vector<PrimitiveInstance>& recorded = s_currWindowCtx->primitiveInstances;
+    s_currWindowCtx->primitiveBatches.push_back(
+        {recorded.size(), count, viewport->Pos, viewport->Size, ImGui::GetIO().DisplayFramebufferScale});
+    recorded.insert(recorded.end(), instances, instances + count);
+    for (auto it = recorded.end() - static_cast<std::ptrdiff_t>(count); it != recorded.end(); ++it)
+        it->rect.position += cursor;
+
+    const std::size_t batch = s_currWindowCtx->primitiveBatches.size() - 1;
+    drawList->AddCallback(drawPrimitivesCallback, reinterpret_cast<void*>(static_cast<std::uintptr_t>(batch)));
+    drawList->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+#else
+    const ImVec2 uv      = ImGui::GetFontTexUvWhitePixel();
+    const auto   rounded = [](const PrimitiveInstance& instance) { return instance.rounding > 0.f; };
+    for (const PrimitiveInstance* const end = instances + count; instances != end;)
+    {
+        // runs of sharp rects are written in bulk like DrawRects and DrawRectsFilled, with room for
+        // outlines reserved for each of them and given back for the filled ones
+        const auto        sharp    = static_cast<std::size_t>(std::find_if(instances, end, rounded) - instances);
+        const std::size_t reserved = sharp > 0 ? reservePrimitives(*drawList, sharp, 8, 24) : 0;
+        int               filled   = 0;
+        for (const PrimitiveInstance* instance = instances; instance != instances + reserved; ++instance)
         {
-            const ImGuiKey mod = keycodeToImGuiMod(keyChanged.code);
-            // The modifier booleans are not reliable when it's the modifier
-            // itself that's being pressed. Detect these presses directly.
-            if (mod != ImGuiKey_None)
+            const sf::Vector2f min = cursor + instance->rect.position;
+            const sf::Vector2f max = min + instance->rect.size;
+            if (instance->borderThickness > 0.f)
             {
-                io.AddKeyEvent(mod, down);
+                writeRectRing(*drawList, min, max, instance->borderThickness, uv, toImU32(instance->color));
             }
             else
             {
-                io.AddKeyEvent(ImGuiMod_Ctrl, keyChanged.control);
-                io.AddKeyEvent(ImGuiMod_Shift, keyChanged.shift);
-                io.AddKeyEvent(ImGuiMod_Alt, keyChanged.alt);
-                io.AddKeyEvent(ImGuiMod_Super, keyChanged.system);
+                writeRectQuad(*drawList, min, max, uv, toImU32(instance->color));
+                ++filled;
             }
-
-            const ImGuiKey key = keycodeToImGuiKey(keyChanged.code);
-            io.AddKeyEvent(key, down);
-            io.SetKeyEventNativeData(key, static_cast<int>(keyChanged.code), -1);
-        };
-        if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
-        {
-            handleKeyChanged(*keyPressed, true);
-        }
-        else if (const auto* keyReleased = event.getIf<sf::Event::KeyReleased>())
-        {
-            handleKeyChanged(*keyReleased, false);
         }
-        else if (const auto* textEntered = event.getIf<sf::Event::TextEntered>())
+        if (filled > 0)
+            drawList->PrimUnreserve(filled * 18, filled * 4);
+        instances += reserved;
+        if (sharp > 0)
+            continue;
+
+        // rounded ones are tessellated by the draw list, which centers borders on the edges
+        const PrimitiveInstance* instance = instances++;
+        const sf::Vector2f       min      = cursor + instance->rect.position;
+        const sf::Vector2f       max      = min + instance->rect.size;
+        const ImU32              col      = toImU32(instance->color);
+        if (instance->borderThickness > 0.f)
         {
-            // Don't handle the event for unprintable characters
-            if (textEntered->unicode >= ' ' && textEntered->unicode != 127)
-                io.AddInputCharacter(textEntered->unicode);
+            const float inset = instance->borderThickness * 0.5f;
+            drawList->AddRect(toImVec2(min + sf::Vector2f(inset, inset)),
+                              toImVec2(max - sf::Vector2f(inset, inset)),
+                              col,
+                              std::max(instance->rounding - inset, 0.f),
+                              ImDrawFlags_None,
+                              instance->borderThickness);
         }
-        else if (const auto* joystickConnected = event.getIf<sf::Event::JoystickConnected>())
+        else
         {
-            if (s_currWindowCtx->joystickId == NULL_JOYSTICK_ID)
-                s_currWindowCtx->joystickId = joystickConnected->joystickId;
+            drawList->AddRectFilled(toImVec2(min), toImVec2(max), col, instance->rounding);
         }
-        else if (const auto* joystickDisconnected = event.getIf<sf::Event::JoystickDisconnected>())
+    }
+#endif
+}
+
+/////////////// Sprite batches
+
+void DrawSprites(const sf::Texture& texture, const SpriteBatchItem* items, std::size_t count)
+{
+    if (count == 0)
+        return;
+
+    ImDrawList*        drawList = ImGui::GetWindowDrawList();
+    const sf::Vector2f cursor   = toSfVector2f(ImGui::GetCursorScreenPos());
+
+    // texture (or atlas) UV range, items' texture rects are mapped into it
+    const auto [uv0, uv1, textureID] = getTextureData(texture);
+    const sf::Vector2f uvOrigin      = toSfVector2f(uv0);
+    const sf::Vector2f uvScale = (toSfVector2f(uv1) - uvOrigin).componentWiseDiv(sf::Vector2f(texture.getSize()));
+
+    drawList->PushTextureID(textureID);
+    while (count > 0)
+    {
+        const std::size_t quads = reserveQuads(*drawList, count);
+        for (const SpriteBatchItem* item = items; item != items + quads; ++item)
         {
-            if (s_currWindowCtx->joystickId == joystickDisconnected->joystickId)
-                // used gamepad was disconnected
-                s_currWindowCtx->joystickId = getConnectedJoystickId();
+            const float        radians  = item->rotation.asRadians();
+            const float        cos      = std::cos(radians);
+            const float        sin      = std::sin(radians);
+            const sf::Vector2f origin   = cursor + item->position;
+            const sf::Vector2f local[4] = {-item->origin,
+                                           sf::Vector2f(item->size.x, 0.f) - item->origin,
+                                           item->size - item->origin,
+                                           sf::Vector2f(0.f, item->size.y) - item->origin};
+
+            ImVec2 corners[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                corners[i] = ImVec2(origin.x + local[i].x * cos - local[i].y * sin,
+                                    origin.y + local[i].x * sin + local[i].y * cos);
+            }
+
+            const sf::FloatRect& rect  = item->textureRect;
+            const sf::Vector2f   uvMin = uvOrigin + rect.position.componentWiseMul(uvScale);
+            const sf::Vector2f   uvMax = uvOrigin + (rect.position + rect.size).componentWiseMul(uvScale);
+            writeQuad(*drawList, corners, toImVec2(uvMin), toImVec2(uvMax), toImU32(item->color));
         }
+        items += quads;
+        count -= quads;
     }
+    drawList->PopTextureID();
+}
 
-    if (event.is<sf::Event::FocusLost>())
+void DrawSprites(const sf::Sprite* sprites, std::size_t count)
+{
+    ImDrawList*        drawList = ImGui::GetWindowDrawList();
+    const sf::Vector2f cursor   = toSfVector2f(ImGui::GetCursorScreenPos());
+
+    // consecutive sprites sharing a texture are written as a single run
+    while (count > 0)
     {
-        io.AddFocusEvent(false);
-        s_currWindowCtx->windowHasFocus = false;
+        const sf::Texture& texture = sprites->getTexture();
+
+        std::size_t runLength = 1;
+        while (runLength < count && &sprites[runLength].getTexture() == &texture)
+            ++runLength;
+
+        const auto [uv0, uv1, textureID] = getTextureData(texture);
+        const sf::Vector2f uvOrigin      = toSfVector2f(uv0);
+        const sf::Vector2f uvScale = (toSfVector2f(uv1) - uvOrigin).componentWiseDiv(sf::Vector2f(texture.getSize()));
+
+        drawList->PushTextureID(textureID);
+        for (std::size_t remaining = runLength; remaining > 0;)
+        {
+            const std::size_t quads = reserveQuads(*drawList, remaining);
+            for (const sf::Sprite* sprite = sprites; sprite != sprites + quads; ++sprite)
+            {
+                const sf::FloatRect  textureRect(sprite->getTextureRect());
+                const sf::Vector2f   size(std::abs(textureRect.size.x), std::abs(textureRect.size.y));
+                const sf::Transform& transform = sprite->getTransform();
+
+                const ImVec2 corners[4] = {toImVec2(cursor + transform.transformPoint({0.f, 0.f})),
+                                           toImVec2(cursor + transform.transformPoint({size.x, 0.f})),
+                                           toImVec2(cursor + transform.transformPoint(size)),
+                                           toImVec2(cursor + transform.transformPoint({0.f, size.y}))};
+
+                const sf::Vector2f uvMin = uvOrigin + textureRect.position.componentWiseMul(uvScale);
+                const sf::Vector2f uvMax = uvOrigin + (textureRect.position + textureRect.size).componentWiseMul(uvScale);
+                writeQuad(*drawList, corners, toImVec2(uvMin), toImVec2(uvMax), toImU32(sprite->getColor()));
+            }
+            sprites += quads;
+            remaining -= quads;
+        }
+        drawList->PopTextureID();
+        count -= runLength;
     }
-    if (event.is<sf::Event::FocusGained>())
+}
+
+/////////////// Sample series plots
+
+void AppendSamples(SampleSeries& series, const float* samples, std::size_t count)
+{
+    series.samples.insert(series.samples.end(), samples, samples + count);
+
+    // only the blocks completed by the new samples are reduced, from the pairs of the level below
+    for (std::size_t depth = 0;; ++depth)
     {
-        io.AddFocusEvent(true);
-        s_currWindowCtx->windowHasFocus = true;
+        const std::size_t belowSize = depth == 0 ? series.samples.size() : series.levels[depth - 1].min.size();
+        if (belowSize < 2)
+            break;
+        if (depth == series.levels.size())
+            series.levels.emplace_back();
+
+        const float* belowMin = depth == 0 ? series.samples.data() : series.levels[depth - 1].min.data();
+        const float* belowMax = depth == 0 ? series.samples.data() : series.levels[depth - 1].max.data();
+
+        SampleSeries::Level& level    = series.levels[depth];
+        const std::size_t    reduced  = level.min.size();
+        const std::size_t    complete = belowSize / 2;
+        if (reduced == complete)
+            break; // nor any level above
+        level.min.resize(complete);
+        level.max.resize(complete);
+
+        // branchless loops over contiguous arrays, so that compilers vectorize the reduction
+        float* const min = level.min.data();
+        float* const max = level.max.data();
+        for (std::size_t i = reduced; i < complete; ++i)
+            min[i] = std::min(belowMin[2 * i], belowMin[2 * i + 1]);
+        for (std::size_t i = reduced; i < complete; ++i)
+            max[i] = std::max(belowMax[2 * i], belowMax[2 * i + 1]);
     }
 }
 
-void Update(sf::RenderWindow& window, sf::Time dt)
+void ClearSamples(SampleSeries& series)
 {
-    Update(window, window, dt);
+    series.samples.clear();
+    series.levels.clear();
 }
 
-void Update(sf::Window& window, sf::RenderTarget& target, sf::Time dt)
+void PlotSeries(const SampleSeries& series, const sf::Vector2f& size, const PlotSeriesSettings& settings)
 {
-    SetCurrentWindow(window);
-    assert(s_currWindowCtx);
+    const sf::Vector2f plotSize(size.x > 0.f ? size.x : ImGui::GetContentRegionAvail().x, size.y);
+    const sf::Vector2f min = toSfVector2f(ImGui::GetCursorScreenPos());
+    const sf::Vector2f max = min + plotSize;
+    ImGui::Dummy(toImVec2(plotSize));
+    if (!ImGui::IsItemVisible())
+        return;
 
-    // Update OS/hardware mouse cursor if imgui isn't drawing a software cursor
-    const ImGuiMouseCursor mouse_cursor = ImGui::GetIO().MouseDrawCursor ? ImGuiMouseCursor_None : ImGui::GetMouseCursor();
-    if (s_currWindowCtx->lastCursor != mouse_cursor)
-    {
-        s_currWindowCtx->lastCursor = mouse_cursor;
-        updateMouseCursor(window);
-    }
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    drawList->AddRectFilled(toImVec2(min),
+                            toImVec2(max),
+                            ImGui::GetColorU32(ImGuiCol_FrameBg),
+                            ImGui::GetStyle().FrameRounding);
 
-    if (!s_currWindowCtx->mouseMoved)
-    {
-        if (sf::Touch::isDown(0))
-            s_currWindowCtx->touchPos = sf::Touch::getPosition(0, window);
+    const std::size_t first   = std::min(settings.first, series.samples.size());
+    const std::size_t count   = std::min(settings.count.value_or(series.samples.size()), series.samples.size() - first);
+    const auto        columns = static_cast<std::size_t>(plotSize.x);
+    if (count == 0 || columns == 0)
+        return;
 
-        Update(s_currWindowCtx->touchPos, sf::Vector2f(target.getSize()), dt);
+    SampleRange bounds;
+    if (!settings.minValue || !settings.maxValue)
+        bounds = reduceSamples(series, first, first + count);
+    const float low      = settings.minValue.value_or(bounds.min);
+    const float high     = settings.maxValue.value_or(bounds.max);
+    const float scale    = high > low ? plotSize.y / (high - low) : 0.f;
+    const float baseline = high > low ? max.y : max.y - plotSize.y * 0.5f; // flat series are centered
+    const auto  toY      = [low, scale, baseline](float value) { return baseline - (value - low) * scale; };
+
+    const float  halfWidth = settings.thickness * 0.5f;
+    const ImVec2 uv        = ImGui::GetFontTexUvWhitePixel();
+    const ImU32  col       = toImU32(settings.color);
+
+    drawList->PushClipRect(toImVec2(min), toImVec2(max), true);
+    if (count <= columns)
+    {
+        // no more than a sample per column: segments between the samples, a single sample is a dot
+        const float       step     = count > 1 ? plotSize.x / static_cast<float>(count - 1) : 0.f;
+        const float*      samples  = series.samples.data() + first;
+        const std::size_t segments = std::max<std::size_t>(count - 1, 1);
+        const auto        toPoint  = [&](std::size_t i)
+        { return sf::Vector2f(min.x + step * static_cast<float>(i), toY(samples[i])); };
+
+        for (std::size_t segment = 0; segment < segments;)
+        {
+            const std::size_t quads = reserveQuads(*drawList, segments - segment);
+            for (const std::size_t end = segment + quads; segment < end; ++segment)
+            {
+                const sf::Vector2f a = toPoint(segment);
+                const sf::Vector2f b = count > 1 ? toPoint(segment + 1) : a + sf::Vector2f(halfWidth, 0.f);
+                writeSegmentQuad(*drawList, a, b, halfWidth, uv, col);
+            }
+        }
     }
     else
     {
-        Update(sf::Mouse::getPosition(window), sf::Vector2f(target.getSize()), dt);
+        // a min/max bar per column, which includes the last sample of the previous column so that
+        // consecutive bars are connected
+        const float columnWidth = plotSize.x / static_cast<float>(columns);
+        for (std::size_t column = 0; column < columns;)
+        {
+            const std::size_t quads = reserveQuads(*drawList, columns - column);
+            for (const std::size_t end = column + quads; column < end; ++column)
+            {
+                const auto        begin = static_cast<std::size_t>(std::uint64_t{column} * count / columns);
+                const auto        last  = static_cast<std::size_t>(std::uint64_t{column + 1} * count / columns);
+                const SampleRange range = reduceSamples(series, first + begin - (begin > 0 ? 1 : 0), first + last);
+
+                const float x = min.x + columnWidth * static_cast<float>(column);
+                writeRectQuad(*drawList,
+                              {x, toY(range.max) - halfWidth},
+                              {x + columnWidth, toY(range.min) + halfWidth},
+                              uv,
+                              col);
+            }
+        }
     }
+    drawList->PopClipRect();
 }
 
-void Update(const sf::Vector2i& mousePos, const sf::Vector2f& displaySize, sf::Time dt)
+} // end of namespace ImGui
+
+namespace
 {
-    assert(s_currWindowCtx && "No current window is set - forgot to call ImGui::SFML::Init?");
+#ifdef IMGUI_SFML_COMPACT_VERTICES
+// Compact vertices (see imconfig-SFML.h) store positions and texture coordinates as 16-bit fixed
+// point, which the renderers scale back to pixels and texture coordinates
+static_assert(sizeof(ImDrawVert) == 12, "IMGUI_SFML_COMPACT_VERTICES expects the layout from imconfig-SFML.h");
+constexpr GLenum vertexCoordinateType = GL_SHORT;
+constexpr float  vertexPositionScale  = 1.0f / decltype(ImDrawVert::pos.x)::steps;
+constexpr float  vertexTexCoordsScale = 1.0f / decltype(ImDrawVert::uv.x)::steps;
+#else
+constexpr GLenum vertexCoordinateType = GL_FLOAT;
+constexpr float  vertexPositionScale  = 1.0f;
+constexpr float  vertexTexCoordsScale = 1.0f;
+#endif
 
-    ImGuiIO& io    = ImGui::GetIO();
-    io.DisplaySize = toImVec2(displaySize);
-    io.DeltaTime   = dt.asSeconds();
+#ifdef IMGUI_SFML_SHADER_RENDERER
+// OpenGL ES 2/3 renderer: the draw lists are streamed into buffer objects and drawn with a
+// minimal shader program, as fixed-function OpenGL ES 1.1 is slow or missing on recent GPUs.
+// The distance field program is only used for the font atlas of SDF fonts, the primitive program
+// (OpenGL ES 3 only) for instanced primitives.
+enum ShaderProgramType
+{
+    CoverageProgram,
+    DistanceFieldProgram,
+    PrimitiveProgram,
+    ShaderProgramCount
+};
 
-    if (s_currWindowCtx->windowHasFocus)
-    {
-        if (io.WantSetMousePos)
-        {
-            sf::Mouse::setPosition(sf::Vector2i(toSfVector2f(io.MousePos)));
-        }
-        else
-        {
-            io.MousePos = toImVec2(sf::Vector2f(mousePos));
-        }
-        for (unsigned int i = 0; i < 3; i++)
-        {
-            io.MouseDown[i] = s_currWindowCtx->touchDown[i] || sf::Touch::isDown(i) ||
-                              s_currWindowCtx->mousePressed[i] || sf::Mouse::isButtonPressed((sf::Mouse::Button)i);
-            s_currWindowCtx->mousePressed[i] = false;
-            s_currWindowCtx->touchDown[i]    = false;
-        }
-    }
+struct ShaderProgram
+{
+    GLuint handle{0};
+    GLint  projection{-1};
+    GLint  texCoordsScale{-1};
+    GLint  texture{-1};
+};
 
-#ifdef ANDROID
-#ifdef USE_JNI
-    if (io.WantTextInput && !s_currWindowCtx->wantTextInput)
+struct ShaderRenderer
+{
+    enum Attribute : GLuint
     {
-        openKeyboardIME();
-        s_currWindowCtx->wantTextInput = true;
-    }
+        Position,
+        TexCoords,
+        Color,
+        InstanceRect,
+        InstanceColor,
+        InstanceShape
+    };
 
-    if (!io.WantTextInput && s_currWindowCtx->wantTextInput)
+    struct StreamBuffer
     {
-        closeKeyboardIME();
-        s_currWindowCtx->wantTextInput = false;
-    }
-#endif
+        GLenum         target{0};
+        GLuint         handle{0};
+        std::size_t    capacity{0};      // bytes, per segment for the persistent ring
+        unsigned char* mapped{nullptr}; // persistent ring only
+    };
+
+    bool          initialized{false};
+    ShaderProgram programs[ShaderProgramCount];
+    StreamBuffer  vertices{GL_ARRAY_BUFFER};
+    StreamBuffer  indices{GL_ELEMENT_ARRAY_BUFFER};
+    StreamBuffer  primitives{GL_ARRAY_BUFFER}; // always orphaned
+
+    // buffers aren't created if empty, the strategy may be a fallback for the requested one
+    std::optional<ImGui::SFML::BufferUploadStrategy> requestedStrategy;
+    ImGui::SFML::BufferUploadStrategy                strategy{ImGui::SFML::BufferUploadStrategy::Orphan};
+
+#ifdef IMGUI_SFML_RENDERER_GLES3
+    // the persistent ring is split in segments written on successive frames, each guarded by a
+    // fence until the GPU is done drawing from it
+    static constexpr std::size_t RingSegments = 3;
+    std::size_t                  ringSegment{0};
+    GLsync                       ringFences[RingSegments]{};
 #endif
+};
 
-    assert(io.Fonts->Fonts.Size > 0); // You forgot to create and set up font
-                                      // atlas (see createFontTexture)
+ShaderRenderer s_shaderRenderer;
 
-    // gamepad navigation
-    if ((io.ConfigFlags & ImGuiConfigFlags_NavEnableGamepad) && s_currWindowCtx->joystickId != NULL_JOYSTICK_ID)
-    {
-        updateJoystickButtonState(io);
-        updateJoystickDPadState(io);
-        updateJoystickAxisState(io);
-    }
+// Geometry of a draw list which stayed unchanged for a few frames, drawn from its own buffers
+struct CachedGeometry
+{
+    std::uint64_t hash{0};
+    std::size_t   vertexSize{0};
+    std::size_t   indexSize{0};
+    unsigned int  unchangedFrames{0};
+    std::uint64_t lastUsedFrame{0};
+    GLuint        vertexBuffer{0};
+    GLuint        indexBuffer{0};
+    bool          uploaded{false}; // buffers hold the data of the current hash
+};
 
-    ImGui::NewFrame();
+struct GeometryCache
+{
+    std::unordered_map<const ImDrawList*, CachedGeometry> entries;
+    std::vector<const CachedGeometry*>                    frameGeometry; // per draw list, streamed if null
+    std::uint64_t                                         frame{0};      // incremented on every render
+};
+
+GeometryCache s_geometryCache;
+
+// Byte offsets of the frame's draw data in the stream buffers
+struct StreamOffsets
+{
+    std::size_t vertices{0};
+    std::size_t indices{0};
+};
+
+// the sources are written in GLSL ES 1.00, and adapted to GLSL ES 3.00 by the preludes
+#ifdef IMGUI_SFML_RENDERER_GLES3
+constexpr const char* shaderVersion = "#version 300 es\n";
+
+constexpr const char* shaderVertexPrelude = "#define attribute in\n"
+                                            "#define varying out\n";
+
+constexpr const char* shaderFragmentPrelude = "#define varying in\n"
+                                              "#define texture2D texture\n"
+                                              "#define gl_FragColor outColor\n"
+                                              "precision mediump float;\n"
+                                              "out vec4 outColor;\n";
+#else
+constexpr const char* shaderVersion = "#version 100\n";
+
+constexpr const char* shaderVertexPrelude = "";
+
+constexpr const char* shaderFragmentPrelude = "precision mediump float;\n";
+#endif
+
+constexpr const char* shaderVertexSource = R"(
+uniform mat4 projection;
+uniform float texCoordsScale;
+attribute vec2 position;
+attribute vec2 texCoords;
+attribute vec4 color;
+varying vec2 fragTexCoords;
+varying vec4 fragColor;
+
+void main()
+{
+    fragTexCoords = texCoords * texCoordsScale;
+    fragColor     = color;
+    gl_Position   = projection * vec4(position, 0.0, 1.0);
 }
+)";
 
-void Render(sf::RenderWindow& window)
+constexpr const char* shaderCoverageSource = R"(
+uniform sampler2D textureSampler;
+varying vec2 fragTexCoords;
+varying vec4 fragColor;
+
+void main()
 {
-    SetCurrentWindow(window);
-    Render(static_cast<sf::RenderTarget&>(window));
+    gl_FragColor = fragColor * texture2D(textureSampler, fragTexCoords);
 }
+)";
 
-void Render(sf::RenderTarget& target)
+constexpr const char* shaderDistanceFieldSource = R"(
+uniform sampler2D textureSampler;
+varying vec2 fragTexCoords;
+varying vec4 fragColor;
+
+void main()
 {
-    target.pushGLStates();
-    ImGui::Render();
-    RenderDrawLists(ImGui::GetDrawData());
-    target.popGLStates();
+    float field    = texture2D(textureSampler, fragTexCoords).a;
+    float width    = max(fwidth(field), 0.0001);
+    float coverage = smoothstep(0.5 - width, 0.5 + width, field);
+    gl_FragColor   = vec4(fragColor.rgb, fragColor.a * coverage);
 }
+)";
+
+#ifdef IMGUI_SFML_RENDERER_GLES3
+// A quad per instance, from gl_VertexID, grown by a pixel for the anti-aliased edge. Positions are
+// relative to the center of the rect.
+constexpr const char* shaderPrimitiveVertexSource = R"(
+uniform mat4 projection;
+attribute vec4 rect;
+attribute vec4 rectColor;
+attribute vec2 shape;
+varying vec2 fragLocal;
+varying vec2 fragHalfSize;
+varying vec2 fragShape;
+varying vec4 fragColor;
+
+void main()
+{
+    vec2 corner  = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)) * 2.0 - 1.0;
+    fragHalfSize = rect.zw * 0.5;
+    fragLocal    = corner * (fragHalfSize + 1.0);
+    fragShape    = vec2(min(shape.x, min(fragHalfSize.x, fragHalfSize.y)), shape.y);
+    fragColor    = rectColor;
+    gl_Position  = projection * vec4(rect.xy + fragHalfSize + fragLocal, 0.0, 1.0);
+}
+)";
 
-void Render()
+constexpr const char* shaderPrimitiveSource = R"(
+precision highp float;
+varying vec2 fragLocal;
+varying vec2 fragHalfSize;
+varying vec2 fragShape;
+varying vec4 fragColor;
+
+void main()
 {
-    ImGui::Render();
-    RenderDrawLists(ImGui::GetDrawData());
+    // signed distance to the rounded rect, negative inside
+    vec2  corner   = abs(fragLocal) - fragHalfSize + fragShape.x;
+    float field    = length(max(corner, 0.0)) + min(max(corner.x, corner.y), 0.0) - fragShape.x;
+    float width    = max(fwidth(field), 0.0001);
+    float coverage = clamp(0.5 - field / width, 0.0, 1.0);
+    if (fragShape.y > 0.0)
+        coverage *= clamp(0.5 + (field + fragShape.y) / width, 0.0, 1.0);
+    gl_FragColor = vec4(fragColor.rgb, fragColor.a * coverage);
 }
+)";
+#endif
 
-void Shutdown(const sf::Window& window)
+[[nodiscard]] GLuint compileShader(GLenum type, const char* extension, const char* source)
 {
-    const bool needReplacement = (s_currWindowCtx->window->getNativeHandle() == window.getNativeHandle());
+    // extensions must be enabled before any other statement
+    const char*   prelude   = type == GL_VERTEX_SHADER ? shaderVertexPrelude : shaderFragmentPrelude;
+    const GLchar* sources[] = {shaderVersion, extension, prelude, source};
 
-    // remove window's context
-    auto found = std::find_if(s_windowContexts.begin(),
-                              s_windowContexts.end(),
-                              [&](std::unique_ptr<WindowContext>& ctx)
-                              { return ctx->window->getNativeHandle() == window.getNativeHandle(); });
-    assert(found != s_windowContexts.end() &&
-           "Window wasn't inited properly: forgot to call ImGui::SFML::Init(window)?");
-    s_windowContexts.erase(found); // s_currWindowCtx can become invalid here!
+    const GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 4, sources, nullptr);
+    glCompileShader(shader);
 
-    // set current context to some window for convenience if needed
-    if (needReplacement)
+    GLint compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled == GL_FALSE)
     {
-        auto it = s_windowContexts.begin();
-        if (it != s_windowContexts.end())
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+[[nodiscard]] ShaderProgram createShaderProgram(const char* vertexSource,
+                                                const char* extension,
+                                                const char* fragmentSource)
+{
+    ShaderProgram program;
+    const GLuint  vertexShader   = compileShader(GL_VERTEX_SHADER, "", vertexSource);
+    const GLuint  fragmentShader = compileShader(GL_FRAGMENT_SHADER, extension, fragmentSource);
+    if (vertexShader && fragmentShader)
+    {
+        program.handle = glCreateProgram();
+        glAttachShader(program.handle, vertexShader);
+        glAttachShader(program.handle, fragmentShader);
+
+        // programs share the attribute locations, only the primitive program reads instances
+        glBindAttribLocation(program.handle, ShaderRenderer::Position, "position");
+        glBindAttribLocation(program.handle, ShaderRenderer::TexCoords, "texCoords");
+        glBindAttribLocation(program.handle, ShaderRenderer::Color, "color");
+        glBindAttribLocation(program.handle, ShaderRenderer::InstanceRect, "rect");
+        glBindAttribLocation(program.handle, ShaderRenderer::InstanceColor, "rectColor");
+        glBindAttribLocation(program.handle, ShaderRenderer::InstanceShape, "shape");
+        glLinkProgram(program.handle);
+
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program.handle, GL_LINK_STATUS, &linked);
+        if (linked == GL_FALSE)
         {
-            // set to some other window
-            s_currWindowCtx = it->get();
-            ImGui::SetCurrentContext(s_currWindowCtx->imContext);
+            glDeleteProgram(program.handle);
+            program.handle = 0;
         }
         else
         {
-            // no alternatives...
-            s_currWindowCtx = nullptr;
-            ImGui::SetCurrentContext(nullptr);
+            program.projection     = glGetUniformLocation(program.handle, "projection");
+            program.texCoordsScale = glGetUniformLocation(program.handle, "texCoordsScale");
+            program.texture        = glGetUniformLocation(program.handle, "textureSampler");
         }
     }
+
+    // flagged for deletion along with the program
+    if (vertexShader)
+        glDeleteShader(vertexShader);
+    if (fragmentShader)
+        glDeleteShader(fragmentShader);
+    return program;
 }
 
-void Shutdown()
+[[nodiscard]] int getGlVersion();
+
+// SFML's EGL backend creates OpenGL ES 1 contexts, in which the shaders can't run. Desktop contexts
+// run them when they're compatible with the targeted OpenGL ES version.
+[[nodiscard]] bool isShaderRendererSupported()
 {
-    s_currWindowCtx = nullptr;
-    ImGui::SetCurrentContext(nullptr);
+    const auto* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    if (!version)
+        return false;
 
-    s_windowContexts.clear();
+    const bool es        = std::strncmp(version, "OpenGL ES", 9) == 0;
+    const int  glVersion = getGlVersion();
+#ifdef IMGUI_SFML_RENDERER_GLES3
+    return es ? glVersion >= 30 : glVersion >= 43 || sf::Context::isExtensionAvailable("GL_ARB_ES3_compatibility");
+#else
+    return es ? glVersion >= 20 : glVersion >= 41 || sf::Context::isExtensionAvailable("GL_ARB_ES2_compatibility");
+#endif
 }
 
-bool UpdateFontTexture()
+// Created on first use, as it needs an active OpenGL ES 2+ context. Objects are shared between
+// SFML's contexts, so a single renderer serves every window.
+[[nodiscard]] ShaderRenderer* getShaderRenderer()
 {
-    assert(s_currWindowCtx);
+    if (!s_shaderRenderer.initialized)
+    {
+        s_shaderRenderer.initialized = true;
+        if (!isShaderRendererSupported())
+            return nullptr;
 
-    ImGuiIO&       io     = ImGui::GetIO();
-    unsigned char* pixels = nullptr;
-    int            width  = 0;
-    int            height = 0;
+#ifdef IMGUI_SFML_RENDERER_GLES2
+        // 32-bit indices are only core since OpenGL ES 3, nothing is drawn without them
+        if (sizeof(ImDrawIdx) == 4 && !sf::Context::isExtensionAvailable("GL_OES_element_index_uint"))
+        {
+            assert(false && "32-bit ImDrawIdx needs GL_OES_element_index_uint with OpenGL ES 2");
+            return nullptr;
+        }
+#endif
 
-    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+        s_shaderRenderer.programs[CoverageProgram] = createShaderProgram(shaderVertexSource, "", shaderCoverageSource);
 
-    sf::Texture newTexture;
-    if (!newTexture.resize(sf::Vector2u(sf::Vector2(width, height))))
-    {
-        return false;
+#ifdef IMGUI_SFML_RENDERER_GLES3
+        const char* derivatives = ""; // core in GLSL ES 3.00
+#else
+        const char* derivatives = "#extension GL_OES_standard_derivatives : require\n";
+#endif
+        s_shaderRenderer.programs[DistanceFieldProgram] = createShaderProgram(shaderVertexSource,
+                                                                              derivatives,
+                                                                              shaderDistanceFieldSource);
+#ifdef IMGUI_SFML_RENDERER_GLES3
+        s_shaderRenderer.programs[PrimitiveProgram] = createShaderProgram(shaderPrimitiveVertexSource,
+                                                                          "",
+                                                                          shaderPrimitiveSource);
+#endif
     }
+    return s_shaderRenderer.programs[CoverageProgram].handle ? &s_shaderRenderer : nullptr;
+}
 
-    newTexture.update(pixels);
-
-    ImTextureID texID = convertGLTextureHandleToImTextureID(newTexture.getNativeHandle());
-    io.Fonts->SetTexID(texID);
+[[nodiscard]] bool hasDistanceFieldProgram()
+{
+    const ShaderRenderer* renderer = getShaderRenderer();
+    return renderer && renderer->programs[DistanceFieldProgram].handle;
+}
 
-    s_currWindowCtx->fontTexture = std::move(newTexture);
+#ifdef IMGUI_SFML_RENDERER_GLES3
+#ifndef GL_MAP_PERSISTENT_BIT_EXT
+#define GL_MAP_PERSISTENT_BIT_EXT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT_EXT
+#define GL_MAP_COHERENT_BIT_EXT 0x0080
+#endif
 
-    return true;
-}
+using BufferStorageFunction = void(GL_APIENTRY*)(GLenum, GLsizeiptr, const void*, GLbitfield);
 
-std::optional<sf::Texture>& GetFontTexture()
+// glBufferStorageEXT isn't exported by libGLESv2, EXT_buffer_storage needs OpenGL ES 3.1
+[[nodiscard]] BufferStorageFunction getBufferStorageFunction()
 {
-    assert(s_currWindowCtx);
-    return s_currWindowCtx->fontTexture;
+    static const BufferStorageFunction s_function = []() -> BufferStorageFunction
+    {
+        if (!sf::Context::isExtensionAvailable("GL_EXT_buffer_storage"))
+            return nullptr;
+        return reinterpret_cast<BufferStorageFunction>(sf::Context::getFunction("glBufferStorageEXT"));
+    }();
+    return s_function;
 }
 
-void SetActiveJoystickId(unsigned int joystickId)
+void waitForFence(GLsync& fence)
 {
-    assert(s_currWindowCtx);
-    assert(joystickId < sf::Joystick::Count);
-    s_currWindowCtx->joystickId = joystickId;
+    if (!fence)
+        return;
+
+    // usually signaled already, the ring is a few frames ahead of the GPU at most
+    while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000) == GL_TIMEOUT_EXPIRED)
+    {
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
 }
 
-void SetJoystickDPadThreshold(float threshold)
+[[nodiscard]] bool createRingBuffer(ShaderRenderer::StreamBuffer& buffer, std::size_t segmentSize)
 {
-    assert(s_currWindowCtx);
-    assert(threshold >= 0.f && threshold <= 100.f);
-    s_currWindowCtx->dPadInfo.threshold = threshold;
+    const BufferStorageFunction bufferStorage = getBufferStorageFunction();
+    if (!bufferStorage)
+        return false;
+
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT_EXT | GL_MAP_COHERENT_BIT_EXT;
+    const auto           size  = static_cast<GLsizeiptr>(segmentSize * ShaderRenderer::RingSegments);
+
+    glGenBuffers(1, &buffer.handle);
+    glBindBuffer(buffer.target, buffer.handle);
+    bufferStorage(buffer.target, size, nullptr, flags);
+    buffer.mapped   = static_cast<unsigned char*>(glMapBufferRange(buffer.target, 0, size, flags));
+    buffer.capacity = segmentSize;
+    return buffer.mapped != nullptr;
 }
+#endif
 
-void SetJoystickLStickThreshold(float threshold)
+void destroyStreamBuffers(ShaderRenderer& renderer)
 {
-    assert(s_currWindowCtx);
-    assert(threshold >= 0.f && threshold <= 100.f);
-    s_currWindowCtx->lStickInfo.threshold = threshold;
+#ifdef IMGUI_SFML_RENDERER_GLES3
+    for (GLsync& fence : renderer.ringFences)
+        waitForFence(fence);
+    renderer.ringSegment = 0;
+#endif
+
+    for (ShaderRenderer::StreamBuffer* buffer : {&renderer.vertices, &renderer.indices})
+    {
+        // deleting a buffer unmaps it
+        if (buffer->handle)
+            glDeleteBuffers(1, &buffer->handle);
+        buffer->handle   = 0;
+        buffer->capacity = 0;
+        buffer->mapped   = nullptr;
+    }
+    renderer.requestedStrategy.reset();
 }
 
-void SetJoystickRStickThreshold(float threshold)
+// Rounds buffer sizes up so that they don't need to grow every frame while the UI grows
+[[nodiscard]] std::size_t getStreamBufferSize(std::size_t capacity, std::size_t requiredSize)
 {
-    assert(s_currWindowCtx);
-    assert(threshold >= 0.f && threshold <= 100.f);
-    s_currWindowCtx->rStickInfo.threshold = threshold;
+    std::size_t size = std::max<std::size_t>(capacity, 64 * 1024);
+    while (size < requiredSize)
+        size += size / 2;
+    return (size + 255) & ~std::size_t{255};
 }
 
-void SetJoystickLTriggerThreshold(float threshold)
+// (Re)creates the stream buffers for the requested strategy, falling back to orphaning when it
+// isn't supported
+void configureStreamBuffers(ShaderRenderer& renderer, std::size_t vertexSize, std::size_t indexSize)
 {
-    assert(s_currWindowCtx);
-    assert(threshold >= -100.f && threshold <= 100.f);
-    s_currWindowCtx->lTriggerInfo.threshold = threshold;
+    using ImGui::SFML::BufferUploadStrategy;
+
+    const std::size_t vertexCapacity = getStreamBufferSize(renderer.vertices.capacity, vertexSize);
+    const std::size_t indexCapacity  = getStreamBufferSize(renderer.indices.capacity, indexSize);
+    destroyStreamBuffers(renderer);
+
+    BufferUploadStrategy strategy = s_bufferUpload.requested;
+    if (strategy == BufferUploadStrategy::ClientMemory)
+    {
+        strategy = BufferUploadStrategy::Orphan; // buffer objects are always used here
+    }
+    else if (strategy == BufferUploadStrategy::PersistentRing)
+    {
+#ifdef IMGUI_SFML_RENDERER_GLES3
+        if (!createRingBuffer(renderer.vertices, vertexCapacity) || !createRingBuffer(renderer.indices, indexCapacity))
+        {
+            destroyStreamBuffers(renderer);
+            strategy = BufferUploadStrategy::Orphan;
+        }
+#else
+        strategy = BufferUploadStrategy::Orphan;
+#endif
+    }
+
+    if (strategy != BufferUploadStrategy::PersistentRing)
+    {
+        const std::pair<ShaderRenderer::StreamBuffer*, std::size_t> buffers[] = {{&renderer.vertices, vertexCapacity},
+                                                                                  {&renderer.indices, indexCapacity}};
+        for (auto [buffer, capacity] : buffers)
+        {
+            glGenBuffers(1, &buffer->handle);
+            glBindBuffer(buffer->target, buffer->handle);
+            glBufferData(buffer->target, static_cast<GLsizeiptr>(capacity), nullptr, GL_STREAM_DRAW);
+            buffer->capacity = capacity;
+        }
+    }
+
+    renderer.requestedStrategy = s_bufferUpload.requested;
+    renderer.strategy          = strategy;
+    s_bufferUpload.effective   = strategy;
 }
 
-void SetJoystickRTriggerThreshold(float threshold)
+// Copies the vertices or the indices of every draw list next to each other, starting at offset
+void writeStreamBuffer(ShaderRenderer::StreamBuffer& buffer, const ImDrawData& drawData, std::size_t offset)
 {
-    assert(s_currWindowCtx);
-    assert(threshold >= -100.f && threshold <= 100.f);
-    s_currWindowCtx->rTriggerInfo.threshold = threshold;
+    const bool vertices = buffer.target == GL_ARRAY_BUFFER;
+    for (int n = 0; n < drawData.CmdListsCount; n++)
+    {
+        if (s_geometryCache.frameGeometry[static_cast<std::size_t>(n)])
+            continue;
+
+        const ImDrawList* cmdList = drawData.CmdLists[n];
+        const void*       data    = vertices ? static_cast<const void*>(cmdList->VtxBuffer.Data)
+                                             : static_cast<const void*>(cmdList->IdxBuffer.Data);
+        const std::size_t size    = vertices ? static_cast<std::size_t>(cmdList->VtxBuffer.Size) * sizeof(ImDrawVert)
+                                             : static_cast<std::size_t>(cmdList->IdxBuffer.Size) * sizeof(ImDrawIdx);
+        if (buffer.mapped)
+            std::memcpy(buffer.mapped + offset, data, size);
+        else
+            glBufferSubData(buffer.target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+        offset += size;
+    }
 }
 
-void SetJoystickMapping(int key, unsigned int joystickButton)
+// Uploads the frame's draw data with the current strategy, leaving the stream buffers bound
+[[nodiscard]] StreamOffsets uploadDrawData(ShaderRenderer& renderer, const ImDrawData& drawData)
 {
-    assert(s_currWindowCtx);
-    assert(key >= ImGuiKey_NamedKey_BEGIN);
-    assert(key < ImGuiKey_NamedKey_END);
-    assert(joystickButton < sf::Joystick::ButtonCount);
-    s_currWindowCtx->joystickMapping[joystickButton] = static_cast<ImGuiKey>(key);
+    using ImGui::SFML::BufferUploadStrategy;
+
+    // lists drawn from cached geometry aren't streamed
+    std::size_t vertexSize = 0;
+    std::size_t indexSize  = 0;
+    for (int n = 0; n < drawData.CmdListsCount; n++)
+    {
+        if (s_geometryCache.frameGeometry[static_cast<std::size_t>(n)])
+            continue;
+        vertexSize += static_cast<std::size_t>(drawData.CmdLists[n]->VtxBuffer.Size) * sizeof(ImDrawVert);
+        indexSize += static_cast<std::size_t>(drawData.CmdLists[n]->IdxBuffer.Size) * sizeof(ImDrawIdx);
+    }
+
+    // a strategy that isn't supported isn't tried again until another one is requested
+    if (renderer.requestedStrategy != s_bufferUpload.requested || vertexSize > renderer.vertices.capacity ||
+        indexSize > renderer.indices.capacity)
+    {
+        configureStreamBuffers(renderer, vertexSize, indexSize);
+    }
+
+    StreamOffsets offsets;
+#ifdef IMGUI_SFML_RENDERER_GLES3
+    if (renderer.strategy == BufferUploadStrategy::PersistentRing)
+    {
+        // the fence is set again once the frame's draws are issued
+        waitForFence(renderer.ringFences[renderer.ringSegment]);
+        offsets.vertices = renderer.ringSegment * renderer.vertices.capacity;
+        offsets.indices  = renderer.ringSegment * renderer.indices.capacity;
+    }
+#endif
+
+    const std::pair<ShaderRenderer::StreamBuffer*, std::size_t> buffers[] = {{&renderer.vertices, offsets.vertices},
+                                                                              {&renderer.indices, offsets.indices}};
+    for (auto [buffer, offset] : buffers)
+    {
+        glBindBuffer(buffer->target, buffer->handle);
+
+        // orphaning the previous storage lets the driver keep it for draws still in flight
+        if (renderer.strategy == BufferUploadStrategy::Orphan)
+            glBufferData(buffer->target, static_cast<GLsizeiptr>(buffer->capacity), nullptr, GL_STREAM_DRAW);
+
+        writeStreamBuffer(*buffer, drawData, offset);
+    }
+    return offsets;
 }
 
-void SetDPadXAxis(sf::Joystick::Axis dPadXAxis, bool inverted)
+// Marks the end of the draws reading the frame's draw data
+void finishDrawDataUpload([[maybe_unused]] ShaderRenderer& renderer)
 {
-    assert(s_currWindowCtx);
-    s_currWindowCtx->dPadInfo.xAxis     = dPadXAxis;
-    s_currWindowCtx->dPadInfo.xInverted = inverted;
+#ifdef IMGUI_SFML_RENDERER_GLES3
+    if (renderer.strategy == ImGui::SFML::BufferUploadStrategy::PersistentRing)
+    {
+        renderer.ringFences[renderer.ringSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        renderer.ringSegment                      = (renderer.ringSegment + 1) % ShaderRenderer::RingSegments;
+    }
+#endif
 }
 
-void SetDPadYAxis(sf::Joystick::Axis dPadYAxis, bool inverted)
+// FNV-1a over 64-bit words. A single differing word always changes the result, which covers the
+// common case of a few vertices moving.
+[[nodiscard]] std::uint64_t hashBytes(const void* data, std::size_t size, std::uint64_t hash = 0xcbf29ce484222325)
 {
-    assert(s_currWindowCtx);
-    s_currWindowCtx->dPadInfo.yAxis     = dPadYAxis;
-    s_currWindowCtx->dPadInfo.yInverted = inverted;
+    constexpr std::uint64_t prime = 0x100000001b3;
+
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (; size >= sizeof(std::uint64_t); size -= sizeof(std::uint64_t), bytes += sizeof(std::uint64_t))
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; size > 0; --size, ++bytes)
+        hash = (hash ^ *bytes) * prime;
+    return hash;
 }
 
-void SetLStickXAxis(sf::Joystick::Axis lStickXAxis, bool inverted)
+void releaseCachedGeometry(CachedGeometry& geometry)
 {
-    assert(s_currWindowCtx);
-    s_currWindowCtx->lStickInfo.xAxis     = lStickXAxis;
-    s_currWindowCtx->lStickInfo.xInverted = inverted;
+    if (geometry.vertexBuffer)
+        glDeleteBuffers(1, &geometry.vertexBuffer);
+    if (geometry.indexBuffer)
+        glDeleteBuffers(1, &geometry.indexBuffer);
+    geometry.vertexBuffer = 0;
+    geometry.indexBuffer  = 0;
+    geometry.uploaded     = false;
 }
 
-void SetLStickYAxis(sf::Joystick::Axis lStickYAxis, bool inverted)
+void clearGeometryCache()
 {
-    assert(s_currWindowCtx);
-    s_currWindowCtx->lStickInfo.yAxis     = lStickYAxis;
-    s_currWindowCtx->lStickInfo.yInverted = inverted;
+    for (auto& [drawList, geometry] : s_geometryCache.entries)
+        releaseCachedGeometry(geometry);
+    s_geometryCache.entries.clear();
+    s_geometryCache.frameGeometry.clear();
 }
 
-void SetRStickXAxis(sf::Joystick::Axis rStickXAxis, bool inverted)
+// Decides which draw lists of the frame are drawn from cached geometry, uploading the lists which
+// just became static. The others are streamed as usual.
+void selectCachedGeometry(const ImDrawData& drawData)
 {
-    assert(s_currWindowCtx);
-    s_currWindowCtx->rStickInfo.xAxis     = rStickXAxis;
-    s_currWindowCtx->rStickInfo.xInverted = inverted;
+    using ImGui::SFML::GeometryCacheStats;
+
+    GeometryCache& cache = s_geometryCache;
+    cache.frameGeometry.assign(static_cast<std::size_t>(drawData.CmdListsCount), nullptr);
+    if (!s_geometryCacheSettings)
+    {
+        if (!cache.entries.empty())
+            clearGeometryCache();
+        return;
+    }
+
+    const ImGui::SFML::GeometryCacheSettings& settings = *s_geometryCacheSettings;
+    GeometryCacheStats&                       stats    = s_geometryCacheStats;
+    stats.listsDrawnFromCache                          = 0;
+    stats.listsUploaded                                = 0;
+    ++cache.frame;
+
+    for (int n = 0; n < drawData.CmdListsCount; n++)
+    {
+        const ImDrawList* cmdList    = drawData.CmdLists[n];
+        const std::size_t vertexSize = static_cast<std::size_t>(cmdList->VtxBuffer.Size) * sizeof(ImDrawVert);
+        const std::size_t indexSize  = static_cast<std::size_t>(cmdList->IdxBuffer.Size) * sizeof(ImDrawIdx);
+        if (vertexSize == 0 || indexSize == 0)
+            continue;
+
+        const std::uint64_t hash = hashBytes(cmdList->IdxBuffer.Data,
+                                             indexSize,
+                                             hashBytes(cmdList->VtxBuffer.Data, vertexSize));
+
+        CachedGeometry& geometry = cache.entries[cmdList];
+        geometry.lastUsedFrame   = cache.frame;
+        if (geometry.hash != hash || geometry.vertexSize != vertexSize || geometry.indexSize != indexSize)
+        {
+            // the buffers are kept, the list may become static again
+            geometry.hash            = hash;
+            geometry.vertexSize      = vertexSize;
+            geometry.indexSize       = indexSize;
+            geometry.unchangedFrames = 0;
+            geometry.uploaded        = false;
+            continue;
+        }
+
+        if (geometry.unchangedFrames < settings.unchangedFrames)
+        {
+            ++geometry.unchangedFrames;
+            continue;
+        }
+
+        if (!geometry.uploaded)
+        {
+            if (!geometry.vertexBuffer)
+            {
+                glGenBuffers(1, &geometry.vertexBuffer);
+                glGenBuffers(1, &geometry.indexBuffer);
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, geometry.vertexBuffer);
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexSize), cmdList->VtxBuffer.Data, GL_STATIC_DRAW);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry.indexBuffer);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexSize), cmdList->IdxBuffer.Data, GL_STATIC_DRAW);
+            geometry.uploaded = true;
+            ++stats.listsUploaded;
+        }
+        else
+        {
+            ++stats.listsDrawnFromCache;
+        }
+        cache.frameGeometry[static_cast<std::size_t>(n)] = &geometry;
+    }
+
+    // release the geometry of draw lists which aren't rendered anymore, e.g. closed windows
+    stats.cachedLists = 0;
+    stats.cachedBytes = 0;
+    for (auto it = cache.entries.begin(); it != cache.entries.end();)
+    {
+        CachedGeometry& geometry = it->second;
+        if (geometry.lastUsedFrame + settings.idleFrames < cache.frame)
+        {
+            releaseCachedGeometry(geometry);
+            it = cache.entries.erase(it);
+            continue;
+        }
+        if (geometry.uploaded)
+        {
+            ++stats.cachedLists;
+            stats.cachedBytes += geometry.vertexSize + geometry.indexSize;
+        }
+        ++it;
+    }
 }
 
-void SetRStickYAxis(sf::Joystick::Axis rStickYAxis, bool inverted)
+void bindListGeometry(const ShaderRenderer& renderer, const CachedGeometry* geometry)
 {
-    assert(s_currWindowCtx);
-    s_currWindowCtx->rStickInfo.yAxis     = rStickYAxis;
-    s_currWindowCtx->rStickInfo.yInverted = inverted;
+    glBindBuffer(GL_ARRAY_BUFFER, geometry ? geometry->vertexBuffer : renderer.vertices.handle);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geometry ? geometry->indexBuffer : renderer.indices.handle);
 }
 
-void SetLTriggerAxis(sf::Joystick::Axis lTriggerAxis)
+void destroyShaderRenderer()
 {
-    assert(s_currWindowCtx);
-    s_currWindowCtx->lTriggerInfo.axis = lTriggerAxis;
+    if (!s_shaderRenderer.initialized)
+        return;
+
+    for (const ShaderProgram& program : s_shaderRenderer.programs)
+    {
+        if (program.handle)
+            glDeleteProgram(program.handle);
+    }
+    destroyStreamBuffers(s_shaderRenderer);
+    if (s_shaderRenderer.primitives.handle)
+        glDeleteBuffers(1, &s_shaderRenderer.primitives.handle);
+    clearGeometryCache();
+    s_shaderRenderer = ShaderRenderer{};
 }
 
-void SetRTriggerAxis(sf::Joystick::Axis rTriggerAxis)
+void SetupRenderState(const ShaderRenderer& renderer, ImDrawData* draw_data, int fb_width, int fb_height)
 {
-    assert(s_currWindowCtx);
-    s_currWindowCtx->rTriggerInfo.axis = rTriggerAxis;
-}
+    // Setup render state: alpha-blending enabled, no face culling, no depth testing, scissor enabled
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_FUNC_ADD);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glEnable(GL_SCISSOR_TEST);
+    glActiveTexture(GL_TEXTURE0);
 
-} // end of namespace SFML
+    // Setup viewport, orthographic projection matrix
+    const float left   = draw_data->DisplayPos.x;
+    const float right  = draw_data->DisplayPos.x + draw_data->DisplaySize.x;
+    const float top    = draw_data->DisplayPos.y;
+    const float bottom = draw_data->DisplayPos.y + draw_data->DisplaySize.y;
+
+    // clang-format off
+    const GLfloat projection[16] = {
+        2.0f * vertexPositionScale / (right - left), 0.0f,                                        0.0f, 0.0f,
+        0.0f,                                        2.0f * vertexPositionScale / (top - bottom), 0.0f, 0.0f,
+        0.0f,                                        0.0f,                                       -1.0f, 0.0f,
+        (right + left) / (left - right),             (top + bottom) / (bottom - top),             0.0f, 1.0f,
+    };
+    // clang-format on
 
-/////////////// Image Overloads for sf::Texture
+    // instanced primitives are positioned in pixels, even with compact vertices
+    GLfloat pixelProjection[16];
+    std::copy(std::begin(projection), std::end(projection), pixelProjection);
+    pixelProjection[0] /= vertexPositionScale;
+    pixelProjection[5] /= vertexPositionScale;
 
-void Image(const sf::Texture& texture, const sf::Color& tintColor, const sf::Color& borderColor)
-{
-    Image(texture, sf::Vector2f(texture.getSize()), tintColor, borderColor);
+    glViewport(0, 0, (GLsizei)fb_width, (GLsizei)fb_height);
+    for (const ShaderProgram& program : renderer.programs)
+    {
+        if (!program.handle)
+            continue;
+        glUseProgram(program.handle);
+        const bool pixels = &program == &renderer.programs[PrimitiveProgram];
+        glUniformMatrix4fv(program.projection, 1, GL_FALSE, pixels ? pixelProjection : projection);
+        glUniform1f(program.texCoordsScale, vertexTexCoordsScale); // not in the primitive program
+        glUniform1i(program.texture, 0);
+    }
+    glUseProgram(renderer.programs[CoverageProgram].handle);
+
+    glBindBuffer(GL_ARRAY_BUFFER, renderer.vertices.handle);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderer.indices.handle);
+    glEnableVertexAttribArray(ShaderRenderer::Position);
+    glEnableVertexAttribArray(ShaderRenderer::TexCoords);
+    glEnableVertexAttribArray(ShaderRenderer::Color);
 }
 
-void Image(const sf::Texture& texture, const sf::Vector2f& size, const sf::Color& tintColor, const sf::Color& borderColor)
+// Points the attributes at the vertices of the bound vertex buffer, starting at the given byte offset
+void SetupVertexAttributes(std::size_t offset)
 {
-    ImTextureID textureID = convertGLTextureHandleToImTextureID(texture.getNativeHandle());
-
-    ImGui::Image(textureID, toImVec2(size), ImVec2(0, 0), ImVec2(1, 1), toImColor(tintColor), toImColor(borderColor));
+    const auto attribute = [offset](std::size_t member) { return reinterpret_cast<const GLvoid*>(offset + member); };
+
+    // compact positions are scaled by the projection, compact texture coordinates by the vertex shader
+    constexpr GLsizei stride = sizeof(ImDrawVert);
+    glVertexAttribPointer(ShaderRenderer::Position,
+                          2,
+                          vertexCoordinateType,
+                          GL_FALSE,
+                          stride,
+                          attribute(offsetof(ImDrawVert, pos)));
+    glVertexAttribPointer(ShaderRenderer::TexCoords,
+                          2,
+                          vertexCoordinateType,
+                          GL_FALSE,
+                          stride,
+                          attribute(offsetof(ImDrawVert, uv)));
+    glVertexAttribPointer(ShaderRenderer::Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, attribute(offsetof(ImDrawVert, col)));
 }
 
-/////////////// Image Overloads for sf::RenderTexture
-void Image(const sf::RenderTexture& texture, const sf::Color& tintColor, const sf::Color& borderColor)
+#ifdef IMGUI_SFML_RENDERER_GLES3
+// Draws a batch of DrawPrimitiveInstances with a single instanced draw. The renderer restores its
+// own state after the callback.
+void drawPrimitivesCallback(const ImDrawList* /*parentList*/, const ImDrawCmd* cmd)
 {
-    Image(texture, sf::Vector2f(texture.getSize()), tintColor, borderColor);
+    ShaderRenderer* renderer = getShaderRenderer();
+    if (!renderer || !renderer->programs[PrimitiveProgram].handle || !s_currWindowCtx)
+        return;
+
+    const auto            index = reinterpret_cast<std::uintptr_t>(cmd->UserCallbackData);
+    const PrimitiveBatch& batch = s_currWindowCtx->primitiveBatches[index];
+
+    // callbacks aren't clipped by the renderer
+    const ImVec2 offset = batch.displayPos;
+    const ImVec2 scale  = batch.framebufferScale;
+    const ImVec2 clipMin((cmd->ClipRect.x - offset.x) * scale.x, (cmd->ClipRect.y - offset.y) * scale.y);
+    const ImVec2 clipMax((cmd->ClipRect.z - offset.x) * scale.x, (cmd->ClipRect.w - offset.y) * scale.y);
+    if (clipMax.x <= clipMin.x || clipMax.y <= clipMin.y)
+        return;
+    const float fbHeight = batch.displaySize.y * scale.y;
+    glScissor((int)clipMin.x, (int)(fbHeight - clipMax.y), (int)(clipMax.x - clipMin.x), (int)(clipMax.y - clipMin.y));
+
+    // orphaned on every batch, so that the GPU can still draw from the previous storage
+    using ImGui::PrimitiveInstance;
+    ShaderRenderer::StreamBuffer& buffer = renderer->primitives;
+    const std::size_t             size   = batch.count * sizeof(PrimitiveInstance);
+    if (!buffer.handle)
+        glGenBuffers(1, &buffer.handle);
+    buffer.capacity = getStreamBufferSize(buffer.capacity, size);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer.handle);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(buffer.capacity), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    0,
+                    static_cast<GLsizeiptr>(size),
+                    &s_currWindowCtx->primitiveInstances[batch.first]);
+
+    struct InstanceAttribute
+    {
+        ShaderRenderer::Attribute location;
+        GLint                     components;
+        GLenum                    type;
+        GLboolean                 normalized;
+        std::size_t               offset;
+    };
+    static_assert(sizeof(sf::FloatRect) == 4 * sizeof(float) && sizeof(sf::Color) == 4);
+    constexpr InstanceAttribute attributes[] = {
+        {ShaderRenderer::InstanceRect, 4, GL_FLOAT, GL_FALSE, offsetof(PrimitiveInstance, rect)},
+        {ShaderRenderer::InstanceColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(PrimitiveInstance, color)},
+        {ShaderRenderer::InstanceShape, 2, GL_FLOAT, GL_FALSE, offsetof(PrimitiveInstance, rounding)}};
+
+    // the per-vertex attributes aren't read by the primitive program
+    glUseProgram(renderer->programs[PrimitiveProgram].handle);
+    for (const GLuint location : {ShaderRenderer::Position, ShaderRenderer::TexCoords, ShaderRenderer::Color})
+        glDisableVertexAttribArray(location);
+    for (const InstanceAttribute& attribute : attributes)
+    {
+        glEnableVertexAttribArray(attribute.location);
+        glVertexAttribPointer(attribute.location,
+                              attribute.components,
+                              attribute.type,
+                              attribute.normalized,
+                              sizeof(PrimitiveInstance),
+                              reinterpret_cast<const GLvoid*>(attribute.offset));
+        glVertexAttribDivisor(attribute.location, 1);
+    }
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(batch.count));
+
+    for (const InstanceAttribute& attribute : attributes)
+    {
+        glVertexAttribDivisor(attribute.location, 0);
+        glDisableVertexAttribArray(attribute.location);
+    }
 }
+#endif
 
-void Image(const sf::RenderTexture& texture, const sf::Vector2f& size, const sf::Color& tintColor, const sf::Color& borderColor)
+// Rendering callback
+void RenderDrawLists(ImDrawData* draw_data)
 {
-    ImTextureID textureID = convertGLTextureHandleToImTextureID(texture.getTexture().getNativeHandle());
+    ImGui::GetDrawData();
+    if (draw_data->CmdListsCount == 0)
+    {
+        return;
+    }
+
+    const ImGuiIO& io = ImGui::GetIO();
+    assert(io.Fonts->TexID != (ImTextureID) nullptr); // You forgot to create and set font texture
+
+    // Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates !=
+    // framebuffer coordinates)
+    const int fb_width  = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+    const int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+    if (fb_width == 0 || fb_height == 0)
+        return;
 
-    ImGui::Image(textureID,
-                 toImVec2(size),
-                 ImVec2(0, 1),
-                 ImVec2(1, 0), // flipped vertically,
-                               // because textures in
-                               // sf::RenderTexture are
-                               // stored this way
-                 toImColor(tintColor),
-                 toImColor(borderColor));
-}
+    // nothing is drawn if the context can't run the shaders, Init reports it for open windows
+    ShaderRenderer* renderer = getShaderRenderer();
+    if (!renderer)
+        return;
 
-/////////////// Image Overloads for sf::Sprite
+    // Backup GL state
+    GLint last_program = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &last_program);
+    GLint last_texture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    GLint last_active_texture = 0;
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &last_active_texture);
+    GLint last_array_buffer = 0;
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
+    GLint last_element_array_buffer = 0;
+    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &last_element_array_buffer);
+    GLint last_viewport[4];
+    glGetIntegerv(GL_VIEWPORT, last_viewport);
+    GLint last_scissor_box[4];
+    glGetIntegerv(GL_SCISSOR_BOX, last_scissor_box);
+    GLint last_blend_src_rgb = 0;
+    glGetIntegerv(GL_BLEND_SRC_RGB, &last_blend_src_rgb);
+    GLint last_blend_dst_rgb = 0;
+    glGetIntegerv(GL_BLEND_DST_RGB, &last_blend_dst_rgb);
+    GLint last_blend_src_alpha = 0;
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &last_blend_src_alpha);
+    GLint last_blend_dst_alpha = 0;
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &last_blend_dst_alpha);
+    GLint last_blend_equation_rgb = 0;
+    glGetIntegerv(GL_BLEND_EQUATION_RGB, &last_blend_equation_rgb);
+    GLint last_blend_equation_alpha = 0;
+    glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &last_blend_equation_alpha);
+
+    const bool last_blend        = glIsEnabled(GL_BLEND);
+    const bool last_cull_face    = glIsEnabled(GL_CULL_FACE);
+    const bool last_depth_test   = glIsEnabled(GL_DEPTH_TEST);
+    const bool last_stencil_test = glIsEnabled(GL_STENCIL_TEST);
+    const bool last_scissor_test = glIsEnabled(GL_SCISSOR_TEST);
+
+    const TraceScope traceScope(ImGui::SFML::TracePhase::RenderDrawLists);
+    const bool       gpuTimerStarted = s_currWindowCtx && beginGpuTimer(s_currWindowCtx->gpuTimer);
+
+    // Upload the whole frame before drawing, then setup desired GL state
+    selectCachedGeometry(*draw_data);
+    const StreamOffsets streamOffsets = uploadDrawData(*renderer, *draw_data);
+    SetupRenderState(*renderer, draw_data, fb_width, fb_height);
+
+    // the distance field font atlas is drawn with its own program
+    std::optional<GLuint> sdfTexture;
+    if (s_currWindowCtx && s_currWindowCtx->sdf && s_currWindowCtx->fontTexture &&
+        renderer->programs[DistanceFieldProgram].handle)
+    {
+        sdfTexture = s_currWindowCtx->fontTexture->getNativeHandle();
+    }
+    ShaderProgramType boundProgram = CoverageProgram;
 
-void Image(const sf::Sprite& sprite, const sf::Color& tintColor, const sf::Color& borderColor)
-{
-    Image(sprite, sprite.getGlobalBounds().size, tintColor, borderColor);
-}
+    // Will project scissor/clipping rectangles into framebuffer space
+    const ImVec2 clip_off   = draw_data->DisplayPos;       // (0,0) unless using multi-viewports
+    const ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display
+                                                           // which are often (2,2)
 
-void Image(const sf::Sprite& sprite, const sf::Vector2f& size, const sf::Color& tintColor, const sf::Color& borderColor)
-{
-    auto [uv0, uv1, textureID] = getSpriteTextureData(sprite);
-    ImGui::Image(textureID, toImVec2(size), uv0, uv1, toImColor(tintColor), toImColor(borderColor));
-}
+    // Render command lists. Streamed lists follow each other in the stream buffers, cached ones
+    // are drawn from their own buffers
+    std::size_t stream_vtx_offset = streamOffsets.vertices;
+    std::size_t stream_idx_offset = streamOffsets.indices;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList*     cmd_list        = draw_data->CmdLists[n];
+        const CachedGeometry* cached          = s_geometryCache.frameGeometry[static_cast<std::size_t>(n)];
+        const std::size_t     list_vtx_offset = cached ? 0 : stream_vtx_offset;
+        const std::size_t     list_idx_offset = cached ? 0 : stream_idx_offset;
+        unsigned int          vtx_offset      = 0;
+        bindListGeometry(*renderer, cached);
+        SetupVertexAttributes(list_vtx_offset);
 
-/////////////// Image Button Overloads for sf::Texture
+        if (s_currWindowCtx)
+            trackDrawListUsage(*s_currWindowCtx, *cmd_list);
 
-bool ImageButton(const char*         id,
-                 const sf::Texture&  texture,
-                 const sf::Vector2f& size,
-                 const sf::Color&    bgColor,
-                 const sf::Color&    tintColor)
-{
-    ImTextureID textureID = convertGLTextureHandleToImTextureID(texture.getNativeHandle());
+        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+        {
+            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+            if (pcmd->VtxOffset != vtx_offset)
+            {
+                // large meshes with 16-bit indices are split using a vertex offset
+                vtx_offset = pcmd->VtxOffset;
+                SetupVertexAttributes(list_vtx_offset + vtx_offset * sizeof(ImDrawVert));
+            }
 
-    return ImGui::ImageButton(id, textureID, toImVec2(size), ImVec2(0, 0), ImVec2(1, 1), toImColor(bgColor), toImColor(tintColor));
-}
+            if (pcmd->UserCallback)
+            {
+                // User callback, registered via ImDrawList::AddCallback()
+                // (ImDrawCallback_ResetRenderState is a special callback value used by the user to
+                // request the renderer to reset render state.)
+                if (pcmd->UserCallback != ImDrawCallback_ResetRenderState)
+                    pcmd->UserCallback(cmd_list, pcmd);
 
-/////////////// Image Button Overloads for sf::RenderTexture
+                // callbacks drawing through SFML change the program and buffer bindings
+                SetupRenderState(*renderer, draw_data, fb_width, fb_height);
+                bindListGeometry(*renderer, cached);
+                SetupVertexAttributes(list_vtx_offset + vtx_offset * sizeof(ImDrawVert));
+                boundProgram = CoverageProgram;
+            }
+            else
+            {
+                // Project scissor/clipping rectangles into framebuffer space
+                ImVec4 clip_rect;
+                clip_rect.x = (pcmd->ClipRect.x - clip_off.x) * clip_scale.x;
+                clip_rect.y = (pcmd->ClipRect.y - clip_off.y) * clip_scale.y;
+                clip_rect.z = (pcmd->ClipRect.z - clip_off.x) * clip_scale.x;
+                clip_rect.w = (pcmd->ClipRect.w - clip_off.y) * clip_scale.y;
 
-bool ImageButton(const char*              id,
-                 const sf::RenderTexture& texture,
-                 const sf::Vector2f&      size,
-                 const sf::Color&         bgColor,
-                 const sf::Color&         tintColor)
-{
-    ImTextureID textureID = convertGLTextureHandleToImTextureID(texture.getTexture().getNativeHandle());
+                if (clip_rect.x < static_cast<float>(fb_width) && clip_rect.y < static_cast<float>(fb_height) &&
+                    clip_rect.z - clip_rect.x >= 0.0f && clip_rect.w - clip_rect.y >= 0.0f)
+                {
+                    // Apply scissor/clipping rectangle
+                    glScissor((int)clip_rect.x,
+                              (int)(static_cast<float>(fb_height) - clip_rect.w),
+                              (int)(clip_rect.z - clip_rect.x),
+                              (int)(clip_rect.w - clip_rect.y));
 
-    return ImGui::ImageButton(id,
-                              textureID,
-                              toImVec2(size),
-                              ImVec2(0, 1),
-                              ImVec2(1, 0), // flipped vertically, because textures in
-                                            // sf::RenderTexture are stored this way
-                              toImColor(bgColor),
-                              toImColor(tintColor));
-}
+                    // Bind texture, Draw
+                    const ImGui::SFML::TextureSampler* sampler       = nullptr;
+                    const std::optional<GLuint>        textureHandle = resolveTextureID(pcmd->GetTexID(), sampler);
+                    if (!textureHandle)
+                        continue;
+
+                    glBindTexture(GL_TEXTURE_2D, *textureHandle);
+
+                    const ShaderProgramType program = textureHandle == sdfTexture ? DistanceFieldProgram
+                                                                                  : CoverageProgram;
+                    if (program != boundProgram)
+                    {
+                        glUseProgram(renderer->programs[program].handle);
+                        boundProgram = program;
+                    }
+
+                    // sampler overrides are applied to the texture object itself, so restore them afterwards
+                    constexpr GLenum samplerParameters[] = {GL_TEXTURE_MIN_FILTER,
+                                                            GL_TEXTURE_MAG_FILTER,
+                                                            GL_TEXTURE_WRAP_S,
+                                                            GL_TEXTURE_WRAP_T};
+                    GLint            lastSamplerState[4] = {};
+                    if (sampler)
+                    {
+                        const GLint filter          = sampler->smooth ? GL_LINEAR : GL_NEAREST;
+                        const GLint wrap            = sampler->repeated ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+                        const GLint samplerState[4] = {filter, filter, wrap, wrap};
+                        for (int i = 0; i < 4; ++i)
+                        {
+                            glGetTexParameteriv(GL_TEXTURE_2D, samplerParameters[i], &lastSamplerState[i]);
+                            glTexParameteri(GL_TEXTURE_2D, samplerParameters[i], samplerState[i]);
+                        }
+                    }
 
-/////////////// Image Button Overloads for sf::Sprite
+                    glDrawElements(GL_TRIANGLES,
+                                   (GLsizei)pcmd->ElemCount,
+                                   sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                                   reinterpret_cast<const GLvoid*>(list_idx_offset +
+                                                                   pcmd->IdxOffset * sizeof(ImDrawIdx)));
+
+                    if (sampler)
+                    {
+                        for (int i = 0; i < 4; ++i)
+                            glTexParameteri(GL_TEXTURE_2D, samplerParameters[i], lastSamplerState[i]);
+                    }
+                }
+            }
+        }
 
-bool ImageButton(const char* id, const sf::Sprite& sprite, const sf::Vector2f& size, const sf::Color& bgColor, const sf::Color& tintColor)
-{
-    auto [uv0, uv1, textureID] = getSpriteTextureData(sprite);
-    return ImGui::ImageButton(id, textureID, toImVec2(size), uv0, uv1, toImColor(bgColor), toImColor(tintColor));
-}
+        if (!cached)
+        {
+            stream_vtx_offset += static_cast<std::size_t>(cmd_list->VtxBuffer.Size) * sizeof(ImDrawVert);
+            stream_idx_offset += static_cast<std::size_t>(cmd_list->IdxBuffer.Size) * sizeof(ImDrawIdx);
+        }
+    }
+    finishDrawDataUpload(*renderer);
 
-/////////////// Draw_list Overloads
+    if (gpuTimerStarted)
+        endGpuTimer(s_currWindowCtx->gpuTimer);
 
-void DrawLine(const sf::Vector2f& a, const sf::Vector2f& b, const sf::Color& color, float thickness)
-{
-    ImDrawList*  draw_list = ImGui::GetWindowDrawList();
-    const ImVec2 pos       = ImGui::GetCursorScreenPos();
-    draw_list->AddLine(ImVec2(a.x + pos.x, a.y + pos.y),
-                       ImVec2(b.x + pos.x, b.y + pos.y),
-                       ColorConvertFloat4ToU32(toImColor(color)),
-                       thickness);
-}
+    // Restore modified GL state
 
-void DrawRect(const sf::FloatRect& rect, const sf::Color& color, float rounding, int rounding_corners, float thickness)
-{
-    ImDrawList* draw_list = ImGui::GetWindowDrawList();
-    draw_list->AddRect(getTopLeftAbsolute(rect),
-                       getDownRightAbsolute(rect),
-                       ColorConvertFloat4ToU32(toImColor(color)),
-                       rounding,
-                       rounding_corners,
-                       thickness);
-}
+    const auto setGlState = [](GLenum state, bool value)
+    {
+        if (value)
+        {
+            glEnable(state);
+        }
+        else
+        {
+            glDisable(state);
+        }
+    };
 
-void DrawRectFilled(const sf::FloatRect& rect, const sf::Color& color, float rounding, int rounding_corners)
-{
-    ImDrawList* draw_list = ImGui::GetWindowDrawList();
-    draw_list->AddRectFilled(getTopLeftAbsolute(rect),
-                             getDownRightAbsolute(rect),
-                             ColorConvertFloat4ToU32(toImColor(color)),
-                             rounding,
-                             rounding_corners);
-}
+    glDisableVertexAttribArray(ShaderRenderer::Position);
+    glDisableVertexAttribArray(ShaderRenderer::TexCoords);
+    glDisableVertexAttribArray(ShaderRenderer::Color);
 
-} // end of namespace ImGui
+    setGlState(GL_BLEND, last_blend);
+    setGlState(GL_CULL_FACE, last_cull_face);
+    setGlState(GL_DEPTH_TEST, last_depth_test);
+    setGlState(GL_STENCIL_TEST, last_stencil_test);
+    setGlState(GL_SCISSOR_TEST, last_scissor_test);
 
-namespace
-{
+    glBlendEquationSeparate(static_cast<GLenum>(last_blend_equation_rgb), static_cast<GLenum>(last_blend_equation_alpha));
+    glBlendFuncSeparate(static_cast<GLenum>(last_blend_src_rgb),
+                        static_cast<GLenum>(last_blend_dst_rgb),
+                        static_cast<GLenum>(last_blend_src_alpha),
+                        static_cast<GLenum>(last_blend_dst_alpha));
+
+    glUseProgram((GLuint)last_program);
+    glBindTexture(GL_TEXTURE_2D, (GLuint)last_texture);
+    glActiveTexture((GLenum)last_active_texture);
+    glBindBuffer(GL_ARRAY_BUFFER, (GLuint)last_array_buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, (GLuint)last_element_array_buffer);
+    glViewport(last_viewport[0], last_viewport[1], (GLsizei)last_viewport[2], (GLsizei)last_viewport[3]);
+    glScissor(last_scissor_box[0], last_scissor_box[1], (GLsizei)last_scissor_box[2], (GLsizei)last_scissor_box[3]);
+}
+#else
 // copied from imgui/backends/imgui_impl_opengl2.cpp
 void SetupRenderState(ImDrawData* draw_data, int fb_width, int fb_height)
 {
@@ -938,8 +5397,30 @@ void SetupRenderState(ImDrawData* draw_data, int fb_width, int fb_height)
             -1.0f,
             +1.0f);
 #endif
+    // compact vertices are scaled back from fixed point, the texture matrix also undoes any pixel
+    // coordinate scaling left over by SFML
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glScalef(vertexTexCoordsScale, vertexTexCoordsScale, 1.0f);
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
+    glScalef(vertexPositionScale, vertexPositionScale, 1.0f);
+}
+
+void SetupVertexPointers(const ImDrawVert* vtx_buffer)
+{
+    glVertexPointer(2,
+                    vertexCoordinateType,
+                    sizeof(ImDrawVert),
+                    (const GLvoid*)((const char*)vtx_buffer + offsetof(ImDrawVert, pos)));
+    glTexCoordPointer(2,
+                      vertexCoordinateType,
+                      sizeof(ImDrawVert),
+                      (const GLvoid*)((const char*)vtx_buffer + offsetof(ImDrawVert, uv)));
+    glColorPointer(4,
+                   GL_UNSIGNED_BYTE,
+                   sizeof(ImDrawVert),
+                   (const GLvoid*)((const char*)vtx_buffer + offsetof(ImDrawVert, col)));
 }
 
 // Rendering callback
@@ -960,7 +5441,6 @@ void RenderDrawLists(ImDrawData* draw_data)
     const int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
     if (fb_width == 0 || fb_height == 0)
         return;
-    draw_data->ScaleClipRects(io.DisplayFramebufferScale);
 
     // Backup GL state
 
@@ -985,6 +5465,8 @@ void RenderDrawLists(ImDrawData* draw_data)
 
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
+    glMatrixMode(GL_TEXTURE);
+    glPushMatrix();
     glMatrixMode(GL_MODELVIEW);
     glPushMatrix();
 
@@ -1014,9 +5496,22 @@ void RenderDrawLists(ImDrawData* draw_data)
     glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TRANSFORM_BIT);
 #endif
 
+    const TraceScope traceScope(ImGui::SFML::TracePhase::RenderDrawLists);
+    const bool       gpuTimerStarted = s_currWindowCtx && beginGpuTimer(s_currWindowCtx->gpuTimer);
+
     // Setup desired GL state
     SetupRenderState(draw_data, fb_width, fb_height);
 
+    // the distance field font atlas is drawn through its shader
+    const sf::Shader*     sdfShader = nullptr;
+    std::optional<GLuint> sdfTexture;
+    if (s_currWindowCtx && s_currWindowCtx->sdf && s_currWindowCtx->fontTexture)
+    {
+        sdfShader  = &s_currWindowCtx->sdf->shader;
+        sdfTexture = s_currWindowCtx->fontTexture->getNativeHandle();
+    }
+    const sf::Shader* boundShader = nullptr;
+
     // Will project scissor/clipping rectangles into framebuffer space
     const ImVec2 clip_off   = draw_data->DisplayPos;       // (0,0) unless using multi-viewports
     const ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display
@@ -1028,25 +5523,36 @@ void RenderDrawLists(ImDrawData* draw_data)
         const ImDrawList* cmd_list   = draw_data->CmdLists[n];
         const ImDrawVert* vtx_buffer = cmd_list->VtxBuffer.Data;
         const ImDrawIdx*  idx_buffer = cmd_list->IdxBuffer.Data;
-        glVertexPointer(2, GL_FLOAT, sizeof(ImDrawVert), (const GLvoid*)((const char*)vtx_buffer + offsetof(ImDrawVert, pos)));
-        glTexCoordPointer(2, GL_FLOAT, sizeof(ImDrawVert), (const GLvoid*)((const char*)vtx_buffer + offsetof(ImDrawVert, uv)));
-        glColorPointer(4,
-                       GL_UNSIGNED_BYTE,
-                       sizeof(ImDrawVert),
-                       (const GLvoid*)((const char*)vtx_buffer + offsetof(ImDrawVert, col)));
+        unsigned int      vtx_offset = 0;
+        SetupVertexPointers(vtx_buffer);
+
+        if (s_currWindowCtx)
+            trackDrawListUsage(*s_currWindowCtx, *cmd_list);
 
         for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
         {
             const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+            if (pcmd->VtxOffset != vtx_offset)
+            {
+                // large meshes with 16-bit indices are split using a vertex offset
+                vtx_offset = pcmd->VtxOffset;
+                SetupVertexPointers(vtx_buffer + vtx_offset);
+            }
+
             if (pcmd->UserCallback)
             {
                 // User callback, registered via ImDrawList::AddCallback()
                 // (ImDrawCallback_ResetRenderState is a special callback value used by the user to
                 // request the renderer to reset render state.)
                 if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
+                {
                     SetupRenderState(draw_data, fb_width, fb_height);
+                    SetupVertexPointers(vtx_buffer + vtx_offset);
+                }
                 else
+                {
                     pcmd->UserCallback(cmd_list, pcmd);
+                }
             }
             else
             {
@@ -1067,19 +5573,61 @@ void RenderDrawLists(ImDrawData* draw_data)
                               (int)(clip_rect.w - clip_rect.y));
 
                     // Bind texture, Draw
-                    const GLuint textureHandle = convertImTextureIDToGLTextureHandle(pcmd->GetTexID());
-                    glBindTexture(GL_TEXTURE_2D, textureHandle);
+                    const ImGui::SFML::TextureSampler* sampler       = nullptr;
+                    const std::optional<GLuint>        textureHandle = resolveTextureID(pcmd->GetTexID(), sampler);
+                    if (!textureHandle)
+                        continue;
+
+                    glBindTexture(GL_TEXTURE_2D, *textureHandle);
+
+                    const sf::Shader* shader = textureHandle == sdfTexture ? sdfShader : nullptr;
+                    if (shader != boundShader)
+                    {
+                        sf::Shader::bind(shader);
+                        boundShader = shader;
+                    }
+
+                    // sampler overrides are applied to the texture object itself, so restore them afterwards
+                    constexpr GLenum samplerParameters[] = {GL_TEXTURE_MIN_FILTER,
+                                                            GL_TEXTURE_MAG_FILTER,
+                                                            GL_TEXTURE_WRAP_S,
+                                                            GL_TEXTURE_WRAP_T};
+                    GLint            lastSamplerState[4] = {};
+                    if (sampler)
+                    {
+                        const GLint filter          = sampler->smooth ? GL_LINEAR : GL_NEAREST;
+                        const GLint wrap            = sampler->repeated ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+                        const GLint samplerState[4] = {filter, filter, wrap, wrap};
+                        for (int i = 0; i < 4; ++i)
+                        {
+                            glGetTexParameteriv(GL_TEXTURE_2D, samplerParameters[i], &lastSamplerState[i]);
+                            glTexParameteri(GL_TEXTURE_2D, samplerParameters[i], samplerState[i]);
+                        }
+                    }
+
                     glDrawElements(GL_TRIANGLES,
                                    (GLsizei)pcmd->ElemCount,
                                    sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
                                    idx_buffer + pcmd->IdxOffset);
+
+                    if (sampler)
+                    {
+                        for (int i = 0; i < 4; ++i)
+                            glTexParameteri(GL_TEXTURE_2D, samplerParameters[i], lastSamplerState[i]);
+                    }
                 }
             }
         }
     }
 
+    if (gpuTimerStarted)
+        endGpuTimer(s_currWindowCtx->gpuTimer);
+
     // Restore modified GL state
 
+    if (boundShader)
+        sf::Shader::bind(nullptr);
+
     const auto setGlState = [](GLint state, bool value)
     {
         if (value)
@@ -1123,6 +5671,8 @@ void RenderDrawLists(ImDrawData* draw_data)
     glBindTexture(GL_TEXTURE_2D, (GLuint)last_texture);
     glMatrixMode(GL_MODELVIEW);
     glPopMatrix();
+    glMatrixMode(GL_TEXTURE);
+    glPopMatrix();
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
 
@@ -1143,6 +5693,193 @@ void RenderDrawLists(ImDrawData* draw_data)
     glDisable(GL_SCISSOR_TEST);
 #endif
 }
+#endif
+
+// Timer query entry points aren't part of OpenGL 1.x, so they're loaded through SFML once a
+// context is active. They're core since OpenGL 3.3, otherwise ARB_timer_query or
+// EXT_timer_query is needed.
+struct TimerQueryFunctions
+{
+    void(APIENTRY* genQueries)(GLsizei, GLuint*){};
+    void(APIENTRY* deleteQueries)(GLsizei, const GLuint*){};
+    void(APIENTRY* beginQuery)(GLenum, GLuint){};
+    void(APIENTRY* endQuery)(GLenum){};
+    void(APIENTRY* getQueryObjectiv)(GLuint, GLenum, GLint*){};
+    void(APIENTRY* getQueryObjectui64v)(GLuint, GLenum, std::uint64_t*){};
+};
+
+#ifndef GL_VERSION_ES_CL_1_1
+// Version of the active context as major * 10 + minor, e.g. 33 for OpenGL 3.3 or 30 for OpenGL ES 3.0
+[[nodiscard]] int getGlVersion()
+{
+    const auto* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    if (!version)
+        return 0;
+
+    // desktop versions start with the number, OpenGL ES ones with "OpenGL ES"
+    while (*version != '\0' && (*version < '0' || *version > '9'))
+        ++version;
+
+    int major = 0;
+    while (*version >= '0' && *version <= '9')
+        major = major * 10 + (*version++ - '0');
+    const int minor = (*version == '.' && version[1] >= '0' && version[1] <= '9') ? version[1] - '0' : 0;
+    return major * 10 + minor;
+}
+#endif
+
+[[nodiscard]] const TimerQueryFunctions* getTimerQueryFunctions()
+{
+#ifdef GL_VERSION_ES_CL_1_1
+    return nullptr;
+#else
+    static const std::optional<TimerQueryFunctions> s_functions = []() -> std::optional<TimerQueryFunctions>
+    {
+        if (getGlVersion() < 33 && !sf::Context::isExtensionAvailable("GL_ARB_timer_query") &&
+            !sf::Context::isExtensionAvailable("GL_EXT_timer_query"))
+        {
+            return std::nullopt;
+        }
+
+        const auto load = [](auto& function, const char* name, const char* fallbackName)
+        {
+            sf::GlFunctionPointer address = sf::Context::getFunction(name);
+            if (!address)
+                address = sf::Context::getFunction(fallbackName);
+            function = reinterpret_cast<std::remove_reference_t<decltype(function)>>(address);
+            return function != nullptr;
+        };
+
+        TimerQueryFunctions functions;
+        if (load(functions.genQueries, "glGenQueries", "glGenQueriesARB") &&
+            load(functions.deleteQueries, "glDeleteQueries", "glDeleteQueriesARB") &&
+            load(functions.beginQuery, "glBeginQuery", "glBeginQueryARB") &&
+            load(functions.endQuery, "glEndQuery", "glEndQueryARB") &&
+            load(functions.getQueryObjectiv, "glGetQueryObjectiv", "glGetQueryObjectivARB") &&
+            load(functions.getQueryObjectui64v, "glGetQueryObjectui64v", "glGetQueryObjectui64vEXT"))
+        {
+            return functions;
+        }
+        return std::nullopt;
+    }();
+    return s_functions ? &*s_functions : nullptr;
+#endif
+}
+
+bool beginGpuTimer(GpuTimer& timer)
+{
+    if (!timer.enabled)
+        return false;
+
+    const TimerQueryFunctions* gl = getTimerQueryFunctions();
+    if (!gl)
+    {
+        // not supported by the driver, don't bother checking again
+        timer.enabled = false;
+        return false;
+    }
+
+    if (!timer.initialized)
+    {
+        gl->genQueries(GpuTimer::QueryCount, timer.queries);
+        timer.contextId   = sf::Context::getActiveContextId();
+        timer.initialized = true;
+    }
+
+    // collect every finished query, keeping the most recent result
+    for (unsigned int i = 0; i < GpuTimer::QueryCount; ++i)
+    {
+        if (!timer.pending[i])
+            continue;
+
+        GLint available = 0;
+        gl->getQueryObjectiv(timer.queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+
+        std::uint64_t elapsedNs = 0;
+        gl->getQueryObjectui64v(timer.queries[i], GL_QUERY_RESULT, &elapsedNs);
+        timer.pending[i] = false;
+
+        if (timer.issuedFrame[i] >= timer.lastReadFrame)
+        {
+            timer.lastReadFrame = timer.issuedFrame[i];
+            timer.lastResult    = sf::microseconds(static_cast<std::int64_t>(elapsedNs / 1000));
+        }
+    }
+
+    // if the GPU is more than QueryCount frames behind, skip timing this frame instead of waiting
+    const unsigned int slot = static_cast<unsigned int>(timer.nextFrame % GpuTimer::QueryCount);
+    if (timer.pending[slot])
+        return false;
+
+    gl->beginQuery(GL_TIME_ELAPSED, timer.queries[slot]);
+    timer.pending[slot]     = true;
+    timer.issuedFrame[slot] = timer.nextFrame;
+    return true;
+}
+
+void endGpuTimer(GpuTimer& timer)
+{
+    getTimerQueryFunctions()->endQuery(GL_TIME_ELAPSED);
+    ++timer.nextFrame;
+}
+
+// Deletes the timer's queries if the GL context they were created in is active and resets it
+void releaseGpuTimer(GpuTimer& timer)
+{
+    if (timer.initialized && sf::Context::getActiveContextId() == timer.contextId)
+        getTimerQueryFunctions()->deleteQueries(GpuTimer::QueryCount, timer.queries);
+    timer = GpuTimer{};
+}
+
+void drawDrawableCallback(const ImDrawList* /*parentList*/, const ImDrawCmd* cmd)
+{
+    assert(s_currRenderTarget && "DrawDrawable needs the frame to be rendered with ImGui::SFML::Render(target)");
+    if (!s_currRenderTarget || !s_currWindowCtx)
+        return;
+
+    const auto             index   = reinterpret_cast<std::uintptr_t>(cmd->UserCallbackData);
+    const DrawableCommand& command = s_currWindowCtx->drawableCommands[index];
+
+    // SFML views take their viewport and scissor as a fraction of the render target. The UI is drawn
+    // in the framebuffer-sized bottom-left corner of the target (see SetupRenderState), while SFML's
+    // fractions start at the top.
+    const ImDrawData*  drawData = ImGui::GetDrawData();
+    const sf::Vector2f displayPos(toSfVector2f(drawData->DisplayPos));
+    const sf::Vector2f scale(toSfVector2f(drawData->FramebufferScale));
+    const sf::Vector2f targetSize(s_currRenderTarget->getSize());
+    const float        framebufferHeight = std::trunc(drawData->DisplaySize.y * scale.y);
+    const sf::Vector2f origin(0.f, targetSize.y - framebufferHeight);
+    const auto         toTargetFraction = [&](sf::Vector2f position)
+    { return (origin + (position - displayPos).componentWiseMul(scale)).componentWiseDiv(targetSize); };
+
+    const sf::Vector2f  clipMin(cmd->ClipRect.x, cmd->ClipRect.y);
+    const sf::Vector2f  clipMax(cmd->ClipRect.z, cmd->ClipRect.w);
+    const sf::FloatRect viewport(toTargetFraction(command.rect.position),
+                                 command.rect.size.componentWiseMul(scale).componentWiseDiv(targetSize));
+    const sf::FloatRect clipRect(toTargetFraction(clipMin),
+                                 (clipMax - clipMin).componentWiseMul(scale).componentWiseDiv(targetSize));
+    const std::optional<sf::FloatRect> scissor = viewport.findIntersection(clipRect);
+    if (!scissor)
+        return;
+
+    sf::View view(command.view);
+    view.setViewport(viewport);
+    view.setScissor(*scissor);
+
+    // SFML's GL state cache doesn't know about the state set up by RenderDrawLists
+    sf::RenderTarget& target = *s_currRenderTarget;
+    target.resetGLStates();
+
+    const sf::View previousView = target.getView();
+    target.setView(view);
+    target.draw(*command.drawable, command.states);
+    target.setView(previousView);
+
+    // unbinding resets the texture matrix SFML sets up for pixel texture coordinates
+    sf::Texture::bind(nullptr);
+}
 
 void initDefaultJoystickMapping()
 {
@@ -1277,6 +6014,48 @@ void updateJoystickAxisState(ImGuiIO& io)
                        false);
 }
 
+[[nodiscard]] std::optional<sf::Cursor::Type> getSystemCursorType(ImGuiMouseCursor cursor)
+{
+    switch (cursor)
+    {
+        case ImGuiMouseCursor_Arrow:
+            return sf::Cursor::Type::Arrow;
+        case ImGuiMouseCursor_TextInput:
+            return sf::Cursor::Type::Text;
+        case ImGuiMouseCursor_ResizeAll:
+            return sf::Cursor::Type::SizeAll;
+        case ImGuiMouseCursor_ResizeNS:
+            return sf::Cursor::Type::SizeVertical;
+        case ImGuiMouseCursor_ResizeEW:
+            return sf::Cursor::Type::SizeHorizontal;
+        case ImGuiMouseCursor_ResizeNESW:
+            return sf::Cursor::Type::SizeBottomLeftTopRight;
+        case ImGuiMouseCursor_ResizeNWSE:
+            return sf::Cursor::Type::SizeTopLeftBottomRight;
+        case ImGuiMouseCursor_Hand:
+            return sf::Cursor::Type::Hand;
+        default:
+            return std::nullopt;
+    }
+}
+
+// Returns the shared system cursor, loading it on first use. Cursors which failed to load
+// aren't retried.
+[[nodiscard]] const sf::Cursor* getSystemCursor(ImGuiMouseCursor cursor)
+{
+    if (cursor < 0 || cursor >= ImGuiMouseCursor_COUNT)
+        return nullptr;
+
+    if (!s_cursorCache.loadAttempted[cursor])
+    {
+        s_cursorCache.loadAttempted[cursor] = true;
+        if (const std::optional<sf::Cursor::Type> type = getSystemCursorType(cursor))
+            s_cursorCache.cursors[cursor] = sf::Cursor::createFromSystem(*type);
+    }
+
+    return s_cursorCache.cursors[cursor] ? &*s_cursorCache.cursors[cursor] : nullptr;
+}
+
 void updateMouseCursor(sf::Window& window)
 {
     const ImGuiIO& io = ImGui::GetIO();
@@ -1291,10 +6070,11 @@ void updateMouseCursor(sf::Window& window)
         {
             window.setMouseCursorVisible(true);
 
-            const sf::Cursor& c = s_currWindowCtx->mouseCursors[cursor]
-                                      ? *s_currWindowCtx->mouseCursors[cursor]
-                                      : *s_currWindowCtx->mouseCursors[ImGuiMouseCursor_Arrow];
-            window.setMouseCursor(c);
+            const sf::Cursor* c = getSystemCursor(cursor);
+            if (!c)
+                c = getSystemCursor(ImGuiMouseCursor_Arrow);
+            if (c)
+                window.setMouseCursor(*c);
         }
     }
 }
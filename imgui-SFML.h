@@ -3,23 +3,33 @@
 
 #include <SFML/Graphics/Color.hpp>
 #include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Angle.hpp>
 #include <SFML/System/Time.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Window/Joystick.hpp>
+#include <SFML/Window/WindowHandle.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
 #include <optional>
+#include <vector>
 
 #include "imgui-SFML_export.h"
 
 namespace sf
 {
+class Drawable;
 class Event;
 class RenderTarget;
 class RenderTexture;
 class RenderWindow;
 class Sprite;
 class Texture;
+class View;
 class Window;
+struct RenderStates;
 } // namespace sf
 
 namespace ImGui
@@ -30,6 +40,27 @@ namespace SFML
 [[nodiscard]] IMGUI_SFML_API bool Init(sf::Window& window, sf::RenderTarget& target, bool loadDefaultFont = true);
 [[nodiscard]] IMGUI_SFML_API bool Init(sf::Window& window, const sf::Vector2f& displaySize, bool loadDefaultFont = true);
 
+struct InitOptions
+{
+    bool loadDefaultFont{true};
+    // Allocations made by the window's ImGui context go through a pool allocator owned by the
+    // backend, see GetAllocatorStats. ImGui's allocator functions are process-wide and installed by
+    // the first Init requesting this; contexts created without it, and memory allocated before,
+    // keep using the previously installed allocator.
+    bool useContextAllocator{false};
+};
+
+[[nodiscard]] IMGUI_SFML_API bool Init(sf::RenderWindow& window, const InitOptions& options);
+[[nodiscard]] IMGUI_SFML_API bool Init(sf::Window& window, sf::RenderTarget& target, const InitOptions& options);
+[[nodiscard]] IMGUI_SFML_API bool Init(sf::Window& window, const sf::Vector2f& displaySize, const InitOptions& options);
+
+// Context pool for windows which are opened and closed often. Up to maxPooledContexts contexts of
+// windows closed with Shutdown(window) are kept, along with their ImGui state (style, fonts,
+// settings), font texture and joystick mapping, and Init reuses them for new windows instead of
+// creating and uploading everything again. Only per-window state is reset. Shutdown() releases
+// them. Disabled (0) by default.
+IMGUI_SFML_API void SetContextPoolSize(std::size_t maxPooledContexts);
+
 IMGUI_SFML_API void SetCurrentWindow(const sf::Window& window);
 IMGUI_SFML_API void ProcessEvent(const sf::Window& window, const sf::Event& event);
 
@@ -48,6 +79,280 @@ IMGUI_SFML_API void Shutdown();
 [[nodiscard]] IMGUI_SFML_API bool UpdateFontTexture();
 IMGUI_SFML_API std::optional<sf::Texture>& GetFontTexture();
 
+// Texture registry. Image/ImageButton overloads refer to registered textures by a generation-checked
+// id instead of their raw GL name. Draw commands which still reference a texture after it was
+// unregistered are skipped (and assert in debug builds) instead of binding a dead or recycled GL
+// texture. Textures must be unregistered before they're destroyed. The optional sampler state only
+// applies while ImGui draws the texture.
+struct TextureSampler
+{
+    bool smooth{false};
+    bool repeated{false};
+};
+
+IMGUI_SFML_API void RegisterTexture(const sf::Texture& texture);
+IMGUI_SFML_API void RegisterTexture(const sf::Texture& texture, const TextureSampler& sampler);
+IMGUI_SFML_API void UnregisterTexture(const sf::Texture& texture);
+
+// Image atlas. When enabled, small registered textures passed to the sf::Texture and sf::Sprite
+// Image/ImageButton overloads are copied into shared atlas pages, so that grids of thumbnails
+// collapse into a handful of draw calls. When all pages are full, the least recently used page is
+// evicted. A texture whose contents change has to be unregistered and registered again to
+// refresh its atlas copy.
+struct ImageAtlasSettings
+{
+    unsigned int pageSize{1024};
+    unsigned int maxPages{4};
+    unsigned int maxImageSize{128}; // larger textures are drawn directly
+};
+
+IMGUI_SFML_API void EnableImageAtlas(const ImageAtlasSettings& settings = {});
+IMGUI_SFML_API void DisableImageAtlas();
+
+// Asynchronous images. Image files are decoded on a pool of worker threads, downscaled to fit in
+// maxSize (keeping their aspect ratio) if set, and uploaded to the GPU by Update in strips of rows,
+// at most uploadBudget bytes of pixels per call (but at least one row), so that large images are
+// spread across frames. The AsyncImage Image/ImageButton overloads draw a placeholder until the
+// image is fully uploaded and request it the first time it's visible. Requests of images which were
+// scrolled out of view before being uploaded are cancelled, and textures which weren't visible for
+// idleFrames frames are released and loaded again when needed. GetAsyncImage returns the same handle
+// for the same path, handles are invalidated by DisableAsyncImages and Shutdown.
+struct AsyncImageSettings
+{
+    unsigned int                workerThreads{2};
+    std::size_t                 uploadBudget{8 * 1024 * 1024};
+    unsigned int                idleFrames{600};
+    std::optional<sf::Vector2u> maxSize; // full resolution if empty
+};
+
+enum class AsyncImageState
+{
+    Unloaded,
+    Loading,
+    Ready,
+    Failed
+};
+
+struct AsyncImage
+{
+    std::uint32_t id{0};
+};
+
+IMGUI_SFML_API void EnableAsyncImages(const AsyncImageSettings& settings = {});
+IMGUI_SFML_API void DisableAsyncImages();
+[[nodiscard]] IMGUI_SFML_API AsyncImage         GetAsyncImage(const std::filesystem::path& path);
+[[nodiscard]] IMGUI_SFML_API AsyncImageState    GetAsyncImageState(AsyncImage image);
+[[nodiscard]] IMGUI_SFML_API const sf::Texture* GetAsyncImageTexture(AsyncImage image); // null until ready
+
+// GPU timing of the UI pass for the current window, measured with GL_TIME_ELAPSED queries
+// (OpenGL 3.3, ARB_timer_query or EXT_timer_query). The result lags a few frames behind and
+// stays empty when timing is disabled or not supported by the driver.
+IMGUI_SFML_API void SetGpuTimerEnabled(bool enabled);
+[[nodiscard]] IMGUI_SFML_API std::optional<sf::Time> GetGpuRenderTime();
+
+// Upload strategy of the draw data for the OpenGL ES shader renderer (see IMGUI_SFML_RENDERER in
+// CMakeLists.txt), shared by all windows. Orphan reallocates the buffers with glBufferData every
+// frame, SubData overwrites them with glBufferSubData, which may stall until the previous frame
+// is drawn, and PersistentRing copies the draw data straight into a persistently mapped,
+// triple-buffered ring synchronized with fences (EXT_buffer_storage, OpenGL ES 3.1 and GLES3
+// builds only). Unsupported strategies fall back to Orphan, GetBufferUploadStrategy returns the
+// one in effect once a frame has been rendered. The fixed-function renderer draws from client
+// memory whatever is requested, and always reports ClientMemory.
+enum class BufferUploadStrategy
+{
+    Orphan,
+    SubData,
+    PersistentRing,
+    ClientMemory
+};
+
+IMGUI_SFML_API void SetBufferUploadStrategy(BufferUploadStrategy strategy);
+[[nodiscard]] IMGUI_SFML_API BufferUploadStrategy GetBufferUploadStrategy();
+
+// Retained geometry for the OpenGL ES shader renderer, shared by all windows. Draw lists whose
+// vertices and indices stay byte-identical for unchangedFrames frames in a row (toolbars, static
+// panels, legends...) are uploaded once to buffers of their own and drawn from them until they
+// change, so that only the lists which changed are streamed every frame. Lists are identified by
+// their ImDrawList, i.e. the window that owns them, and a hash of their contents. The geometry of
+// lists not rendered for idleFrames frames is released. The fixed-function renderer draws from
+// client memory and ignores the cache.
+struct GeometryCacheSettings
+{
+    unsigned int unchangedFrames{2};
+    unsigned int idleFrames{120};
+};
+
+struct GeometryCacheStats
+{
+    std::size_t cachedLists{0};
+    std::size_t cachedBytes{0};
+    std::size_t listsDrawnFromCache{0}; // in the last rendered frame
+    std::size_t listsUploaded{0};       // in the last rendered frame
+};
+
+IMGUI_SFML_API void EnableGeometryCache(const GeometryCacheSettings& settings = {});
+IMGUI_SFML_API void DisableGeometryCache();
+[[nodiscard]] IMGUI_SFML_API GeometryCacheStats GetGeometryCacheStats();
+
+// Low-latency input mode for the current window, for use with vsync. WaitForInputDeadline, called
+// right before polling events, sleeps until the latest point at which events can be processed and
+// the frame built and rendered before the next vsync, estimated from the measured frame period
+// and frame times. MarkFramePresented must be called right after window.display(). When the
+// software cursor is used (io.MouseDrawCursor), it can be drawn where the mouse is predicted to be
+// at present time. Both functions do nothing while the mode is disabled.
+struct LowLatencySettings
+{
+    sf::Time safetyMargin{sf::milliseconds(2)}; // kept between the end of rendering and the vsync
+    bool     predictCursor{true};
+};
+
+IMGUI_SFML_API void EnableLowLatencyMode(const LowLatencySettings& settings = {});
+IMGUI_SFML_API void DisableLowLatencyMode();
+IMGUI_SFML_API void WaitForInputDeadline();
+IMGUI_SFML_API void MarkFramePresented();
+// Time from the mouse sampling in Update to the end of the last presented frame's display()
+[[nodiscard]] IMGUI_SFML_API std::optional<sf::Time> GetInputToPresentLatency();
+
+// Signed distance field fonts for the current window. The font atlas is baked once as a distance
+// field and text is drawn through a small fragment shader, so that it stays sharp at any scale
+// (SetWindowFontScale, zoomed canvases, DPI scaling) without baking more sizes. Fonts should be
+// added at a fairly large size (32 pixels or more) for the outlines to be accurate. spread is the
+// distance in atlas pixels covered by the field around the outlines. Returns false if shaders
+// aren't available, in which case the bitmap atlas is kept. Both must be called outside of a frame,
+// and fonts added later are converted by UpdateFontTexture.
+struct SdfFontSettings
+{
+    float spread{4.f};
+};
+
+IMGUI_SFML_API bool EnableSdfFonts(const SdfFontSettings& settings = {});
+IMGUI_SFML_API bool DisableSdfFonts();
+
+// DPI scaling for the current window. Update(window, target, dt) lays the UI out in window
+// coordinates divided by the content scale of the window's monitor, and sets
+// io.DisplayFramebufferScale from the ratio of the target's size to that layout size (it can also
+// be set directly when using the low-level Update). SFML doesn't report monitor DPI, so the content
+// scale (1 by default) comes from SetDpiContentScale, called again when the window changes monitor;
+// mouse positions given to ProcessEvent and Update stay in window coordinates. Fonts are baked
+// again at every framebuffer scale the window is displayed at, and up to maxCachedAtlases scaled
+// atlases and their textures are kept, so that moving the window back and forth between monitors
+// swaps atlases instead of rebuilding them. Scaled atlases are baked from the fonts of the
+// context's atlas, which must not be modified while a scaled one is in use (call UpdateFontTexture
+// after changing fonts). io.FontGlobalScale is managed while DPI scaling is enabled; fonts used
+// with PushFont should be taken from io.Fonts->Fonts, whose indices are the same in every atlas.
+struct DpiSettings
+{
+    std::size_t maxCachedAtlases{3};
+};
+
+IMGUI_SFML_API void EnableDpiScaling(const DpiSettings& settings = {});
+IMGUI_SFML_API void SetDpiContentScale(float contentScale);
+IMGUI_SFML_API void DisableDpiScaling();
+
+// Input recording and replay. While recording, every event passed to ProcessEvent for the current
+// window and the parameters of its Update calls (along with the mouse buttons Update sampled) are
+// written to a compact binary stream, which must stay alive until recording stops. The focus of the
+// window when recording starts is stored too, later changes are recorded through their events.
+IMGUI_SFML_API void StartInputRecording(std::ostream& out);
+IMGUI_SFML_API void StopInputRecording();
+
+using ReplayFrameFn = void (*)(void* userData);
+
+// Replays a recording at full speed into the context of the given window, which must have been
+// initialized. Devices aren't polled during the replay (nor for a window which was never opened), so
+// it gives a deterministic headless context. The window has the recorded focus while replaying and
+// gets its own focus back afterwards. For each recorded frame, buildFrame submits the widgets after
+// Update, then the frame is rendered into target, or ended with ImGui::Render if it's null.
+// Returns the number of frames replayed, or nothing if the stream isn't a valid recording.
+[[nodiscard]] IMGUI_SFML_API std::optional<std::size_t> ReplayInput(const sf::Window& window,
+                                                                    std::istream&     in,
+                                                                    ReplayFrameFn     buildFrame,
+                                                                    void*             userData = nullptr,
+                                                                    sf::RenderTarget* target   = nullptr);
+
+// Memory used by the current window's ImGui context, empty unless it was initialized with
+// InitOptions::useContextAllocator
+struct AllocatorStats
+{
+    std::size_t liveBytes{0}; // requested by ImGui and not freed yet
+    std::size_t peakBytes{0};
+    std::size_t reservedBytes{0}; // held by the allocator, including free blocks
+    std::size_t allocationsLastFrame{0};
+    std::size_t totalAllocations{0};
+};
+
+[[nodiscard]] IMGUI_SFML_API std::optional<AllocatorStats> GetAllocatorStats();
+
+// Memory held by the backend and by every ImGui context it created. Draw buffers are the
+// vertex, index and command buffers of the draw lists rendered last frame.
+struct ContextMemoryReport
+{
+    sf::WindowHandle              window{};
+    std::size_t                   fontTextureBytes{0};
+    std::size_t                   fontPixelBytes{0}; // CPU copy of the font atlas kept by ImGui
+    std::size_t                   drawListCount{0};
+    std::size_t                   drawBufferBytes{0}; // capacity
+    std::size_t                   drawBufferUsedBytes{0};
+    std::size_t                   backendBufferBytes{0};
+    std::optional<AllocatorStats> allocator; // all of ImGui's allocations, if the context allocator is used
+};
+
+struct MemoryReport
+{
+    std::vector<ContextMemoryReport> contexts;
+    std::size_t                      cursorCount{0}; // system cursors, owned by the OS
+    std::size_t                      atlasTextureBytes{0};
+    std::size_t                      viewportTextureBytes{0};
+    std::size_t                      asyncImageTextureBytes{0};
+    std::size_t                      registeredTextureCount{0};
+};
+
+[[nodiscard]] IMGUI_SFML_API MemoryReport GetMemoryReport();
+
+// Releases memory kept after peaks of use. Draw buffers are shrunk to their peak use of the last
+// oversizedFrames frames if that's less than their capacity divided by slack. Must be called
+// between frames, after rendering.
+struct TrimPolicy
+{
+    unsigned int oversizedFrames{600};
+    float        slack{2.f};
+    bool         releaseGpuCaches{true};   // image atlas pages, viewport render textures and async images
+    bool         releaseFontPixels{false}; // rebuilt by UpdateFontTexture, e.g. after adding a font
+};
+
+IMGUI_SFML_API void TrimMemory(const TrimPolicy& policy = {});
+
+// tracing of backend frame phases
+enum class TracePhase
+{
+    ProcessEvents, // all ProcessEvent calls between two frames
+    Update,
+    NewFrame,
+    Render, // ImGui::Render
+    UpdateFontTexture,
+    RenderDrawLists
+};
+
+struct TraceEvent
+{
+    TracePhase       phase{};
+    sf::WindowHandle window{}; // window the phase ran for
+    sf::Time         begin;    // relative to a process-wide epoch
+    sf::Time         end;
+};
+
+using TraceSink = void (*)(const TraceEvent& event, void* userData);
+
+// Recorded events are kept in a fixed-size lock-free ring (oldest events are dropped when it's
+// full) and are additionally forwarded to the sink, if one is set
+IMGUI_SFML_API void SetTracingEnabled(bool enabled);
+IMGUI_SFML_API void SetTraceSink(TraceSink sink, void* userData = nullptr);
+[[nodiscard]] IMGUI_SFML_API const char* GetTracePhaseName(TracePhase phase);
+// Writes the events recorded since the last flush as Chrome trace-event JSON (loadable in
+// chrome://tracing and Perfetto). May be called from another thread. Returns the number of
+// events written.
+IMGUI_SFML_API std::size_t FlushChromeTrace(std::ostream& out);
+
 // joystick functions
 IMGUI_SFML_API void SetActiveJoystickId(unsigned int joystickId);
 IMGUI_SFML_API void SetJoystickDPadThreshold(float threshold);
@@ -65,6 +370,35 @@ IMGUI_SFML_API void SetRStickXAxis(sf::Joystick::Axis rStickXAxis, bool inverted
 IMGUI_SFML_API void SetRStickYAxis(sf::Joystick::Axis rStickYAxis, bool inverted = false);
 IMGUI_SFML_API void SetLTriggerAxis(sf::Joystick::Axis lTriggerAxis);
 IMGUI_SFML_API void SetRTriggerAxis(sf::Joystick::Axis rTriggerAxis);
+
+// Draws SFML content in place inside the current window, without an intermediate
+// sf::RenderTexture. The drawable is drawn during Render(target) into an area of the given size at
+// the cursor position (clipped by the window), through the given view or one which maps
+// (0, 0)-(size) to that area. The drawable must stay alive until the frame is rendered.
+IMGUI_SFML_API void DrawDrawable(const sf::Drawable& drawable, const sf::RenderStates& states, const sf::Vector2f& size);
+IMGUI_SFML_API void DrawDrawable(const sf::Drawable&     drawable,
+                                 const sf::RenderStates& states,
+                                 const sf::Vector2f&     size,
+                                 const sf::View&         view);
+
+// Viewport widgets drawn through pooled render textures. Pooled textures are bucketed by size and
+// shared between viewports and frames, so resizing a panel doesn't reallocate on every frame;
+// textures unused for a few seconds are released. Draw into the returned render texture (its view
+// maps (0, 0)-(size); keep the view's viewport when changing it) and call EndViewport, which adds
+// the image at the cursor position. When a GPU time budget is set, the viewport is rendered at a
+// lower resolution while it's exceeded and upscaled when displayed. Returns nullptr if nothing
+// can be drawn, EndViewport may still be called and does nothing then.
+struct ViewportSettings
+{
+    std::optional<sf::Time> gpuBudget; // GPU time allowed for drawing the viewport's contents
+    float                   minResolutionScale{0.5f};
+};
+
+[[nodiscard]] IMGUI_SFML_API sf::RenderTexture* BeginViewport(const char*             id,
+                                                              const sf::Vector2f&     size,
+                                                              const ViewportSettings& settings = {});
+IMGUI_SFML_API void EndViewport();
+IMGUI_SFML_API void ClearViewportPool(); // releases every pooled render texture
 } // end of namespace SFML
 
 // custom SFML overloads for ImGui widgets
@@ -96,6 +430,12 @@ IMGUI_SFML_API void Image(const sf::Sprite&   sprite,
                           const sf::Color&    tintColor   = sf::Color::White,
                           const sf::Color&    borderColor = sf::Color::Transparent);
 
+// Image overloads for asynchronous images
+IMGUI_SFML_API void Image(ImGui::SFML::AsyncImage image,
+                          const sf::Vector2f&     size,
+                          const sf::Color&        tintColor   = sf::Color::White,
+                          const sf::Color&        borderColor = sf::Color::Transparent);
+
 // ImageButton overloads for sf::Texture
 IMGUI_SFML_API bool ImageButton(const char*         id,
                                 const sf::Texture&  texture,
@@ -117,6 +457,13 @@ IMGUI_SFML_API bool ImageButton(const char*         id,
                                 const sf::Color&    bgColor   = sf::Color::Transparent,
                                 const sf::Color&    tintColor = sf::Color::White);
 
+// ImageButton overloads for asynchronous images
+IMGUI_SFML_API bool ImageButton(const char*             id,
+                                ImGui::SFML::AsyncImage image,
+                                const sf::Vector2f&     size,
+                                const sf::Color&        bgColor   = sf::Color::Transparent,
+                                const sf::Color&        tintColor = sf::Color::White);
+
 // Draw_list overloads. All positions are in relative coordinates (relative to top-left of the
 // current window)
 IMGUI_SFML_API void DrawLine(const sf::Vector2f& a, const sf::Vector2f& b, const sf::Color& col, float thickness = 1.0f);
@@ -129,6 +476,90 @@ IMGUI_SFML_API void DrawRectFilled(const sf::FloatRect& rect,
                                    const sf::Color&     color,
                                    float                rounding         = 0.0f,
                                    int                  rounding_corners = 0x0F);
+
+// Bulk draw_list overloads. Each call reserves draw list space once for all primitives. Segments and
+// rect outlines are written as plain quads, without ImGui's anti-aliased fringe.
+IMGUI_SFML_API void DrawPolyline(const sf::Vector2f* points,
+                                 std::size_t         count,
+                                 const sf::Color&    color,
+                                 float               thickness = 1.0f,
+                                 bool                closed    = false);
+// Draws count / 2 segments between consecutive pairs of points
+IMGUI_SFML_API void DrawLines(const sf::Vector2f* points,
+                              std::size_t         count,
+                              const sf::Color&    color,
+                              float               thickness = 1.0f);
+IMGUI_SFML_API void DrawRects(const sf::FloatRect* rects,
+                              std::size_t          count,
+                              const sf::Color&     color,
+                              float                thickness = 1.0f);
+IMGUI_SFML_API void DrawRectsFilled(const sf::FloatRect* rects, std::size_t count, const sf::Color& color);
+IMGUI_SFML_API void DrawRectsFilled(const sf::FloatRect* rects, const sf::Color* colors, std::size_t count);
+
+// Instanced primitives. Rounded rects and circles are recorded as 28 byte instances instead of being
+// tessellated into vertices, and the instances of each call are drawn by the GPU with a single
+// instanced draw and a distance field shader. A circle is a square rounded by half its size.
+// Rects are relative to the cursor position, like the draw list overloads above. Instancing needs
+// the OpenGL ES 3 renderer, the other renderers write sharp rects straight into the draw list in
+// bulk, and tessellate rounded ones through it.
+struct PrimitiveInstance
+{
+    sf::FloatRect rect;
+    sf::Color     color;
+    float         rounding{0.f};        // corner radius, clamped to half the smallest side
+    float         borderThickness{0.f}; // drawn inside the rect, filled if 0
+};
+
+IMGUI_SFML_API void DrawPrimitiveInstances(const PrimitiveInstance* instances, std::size_t count);
+
+// Sprite batches. Quads are written straight into the current window's draw list without creating
+// ImGui items, so there's no per-sprite layout or ID cost. Positions are relative to the cursor
+// position, like the draw list overloads above.
+struct SpriteBatchItem
+{
+    sf::FloatRect textureRect; // in pixels
+    sf::Vector2f  position;
+    sf::Vector2f  size;
+    sf::Vector2f  origin; // of position and rotation, relative to the top-left corner of the quad
+    sf::Angle     rotation;
+    sf::Color     color{sf::Color::White};
+};
+
+IMGUI_SFML_API void DrawSprites(const sf::Texture& texture, const SpriteBatchItem* items, std::size_t count);
+IMGUI_SFML_API void DrawSprites(const sf::Sprite* sprites, std::size_t count);
+
+// Sample series plots. Appended samples are also reduced into a pyramid of min/max pairs, each level
+// covering twice as many samples per pair as the one below, so that plotting reads a few pairs per
+// pixel column however long the series is. Columns covering several samples are drawn as min/max
+// bars, written straight into the draw list like the bulk overloads above.
+struct SampleSeries
+{
+    struct Level
+    {
+        std::vector<float> min;
+        std::vector<float> max;
+    };
+
+    std::vector<float> samples;
+    std::vector<Level> levels; // maintained by AppendSamples
+};
+
+struct PlotSeriesSettings
+{
+    sf::Color                  color{sf::Color::White};
+    float                      thickness{1.f};
+    std::size_t                first{0}; // first plotted sample
+    std::optional<std::size_t> count;    // plotted samples, up to the end of the series if empty
+    std::optional<float>       minValue; // bottom of the plot, the smallest plotted sample if empty
+    std::optional<float>       maxValue; // top of the plot, the largest plotted sample if empty
+};
+
+IMGUI_SFML_API void AppendSamples(SampleSeries& series, const float* samples, std::size_t count);
+IMGUI_SFML_API void ClearSamples(SampleSeries& series);
+// The plot takes the available width if size.x <= 0
+IMGUI_SFML_API void PlotSeries(const SampleSeries&       series,
+                               const sf::Vector2f&       size,
+                               const PlotSeriesSettings& settings = PlotSeriesSettings());
 } // end of namespace ImGui
 
 #endif // # IMGUI_SFML_H
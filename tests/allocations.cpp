@@ -0,0 +1,79 @@
+#include "headless-context.h"
+
+#include <SFML/Window/Event.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<bool>        countAllocations{false};
+std::atomic<std::size_t> allocationCount{0};
+
+// ImGui allocates through ImGui::MemAlloc, which doesn't go through operator new
+void* countImGuiAllocation(std::size_t size, void* /*userData*/)
+{
+    if (countAllocations.load(std::memory_order_relaxed))
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size);
+}
+
+void freeImGuiAllocation(void* ptr, void* /*userData*/)
+{
+    std::free(ptr);
+}
+} // namespace
+
+// replaces the global allocator for this executable only, the array forms forward to these
+void* operator new(std::size_t size)
+{
+    if (countAllocations.load(std::memory_order_relaxed))
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+TEST_CASE("Steady-state frames don't allocate")
+{
+    ImGui::SetAllocatorFunctions(countImGuiAllocation, freeImGuiAllocation);
+
+    HeadlessContext context(sf::Vector2f(800.f, 600.f));
+    sf::Window&     window = context.window;
+
+    const auto frame = [&window]
+    {
+        ImGui::SFML::ProcessEvent(window, sf::Event::MouseMoved{{10, 10}});
+        ImGui::SFML::Update(sf::Vector2i(10, 10), sf::Vector2f(800.f, 600.f), sf::milliseconds(16));
+
+        ImGui::Begin("Window");
+        ImGui::Text("Frame %d", ImGui::GetFrameCount());
+        ImGui::DrawRectFilled(sf::FloatRect({0.f, 0.f}, {10.f, 10.f}), sf::Color::Red);
+        ImGui::End();
+
+        ImGui::Render();
+    };
+
+    // warm up the backend's buffers
+    for (int i = 0; i < 10; ++i)
+        frame();
+
+    countAllocations = true;
+    for (int i = 0; i < 100; ++i)
+        frame();
+    countAllocations = false;
+
+    CHECK(allocationCount == 0);
+}
@@ -0,0 +1,123 @@
+#include "headless-context.h"
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include <filesystem>
+#include <initializer_list>
+
+namespace
+{
+void drawImages(std::initializer_list<ImGui::SFML::AsyncImage> images)
+{
+    ImGui::SFML::Update(sf::Vector2i(), sf::Vector2f(640.f, 480.f), sf::milliseconds(16));
+    ImGui::SetNextWindowPos(ImVec2(0.f, 0.f));
+    ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+    ImGui::Begin("Images");
+    for (const ImGui::SFML::AsyncImage image : images)
+        ImGui::Image(image, sf::Vector2f(64.f, 64.f));
+    ImGui::End();
+    ImGui::Render();
+}
+
+void drawImage(ImGui::SFML::AsyncImage image)
+{
+    drawImages({image});
+}
+} // namespace
+
+TEST_CASE("Async images")
+{
+    using ImGui::SFML::AsyncImageState;
+
+    const HeadlessContext context(sf::Vector2f(640.f, 480.f));
+    ImGui::SFML::EnableAsyncImages();
+
+    const ImGui::SFML::AsyncImage missing = ImGui::SFML::GetAsyncImage("missing.png");
+    CHECK(ImGui::SFML::GetAsyncImage("missing.png").id == missing.id);
+    CHECK(ImGui::SFML::GetAsyncImage("other.png").id != missing.id);
+    CHECK(ImGui::SFML::GetAsyncImageState(missing) == AsyncImageState::Unloaded);
+
+    // requested once visible, the placeholder is drawn until the worker gives up on the file
+    drawImage(missing);
+    CHECK(ImGui::SFML::GetAsyncImageState(missing) == AsyncImageState::Loading);
+    for (int frame = 0; frame < 500 && ImGui::SFML::GetAsyncImageState(missing) == AsyncImageState::Loading; ++frame)
+    {
+        sf::sleep(sf::milliseconds(10));
+        drawImage(missing);
+    }
+    CHECK(ImGui::SFML::GetAsyncImageState(missing) == AsyncImageState::Failed);
+    CHECK(ImGui::SFML::GetAsyncImageTexture(missing) == nullptr);
+}
+
+TEST_CASE("Async images are downscaled and uploaded across frames")
+{
+    using ImGui::SFML::AsyncImageState;
+
+    // the textures need an OpenGL context
+    if (!canCreateGlContext())
+        return;
+
+    // red on the left half, blue on the right half
+    sf::Image source(sf::Vector2u(256, 200), sf::Color::Red);
+    for (unsigned int y = 0; y < 200; ++y)
+    {
+        for (unsigned int x = 128; x < 256; ++x)
+            source.setPixel(sf::Vector2u(x, y), sf::Color::Blue);
+    }
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::filesystem::path path      = directory / "imgui-sfml-async-image.png";
+    const std::filesystem::path other     = directory / "imgui-sfml-async-image-other.png";
+    REQUIRE(source.saveToFile(path));
+    REQUIRE(source.saveToFile(other));
+
+    const HeadlessContext context(sf::Vector2f(640.f, 480.f));
+
+    // one worker decodes the requests in order, and a single row of the downscaled image fits in
+    // the budget
+    ImGui::SFML::AsyncImageSettings settings;
+    settings.workerThreads = 1;
+    settings.uploadBudget  = 128 * 4;
+    settings.maxSize       = sf::Vector2u(128, 128);
+    ImGui::SFML::EnableAsyncImages(settings);
+
+    const ImGui::SFML::AsyncImage image     = ImGui::SFML::GetAsyncImage(path);
+    const ImGui::SFML::AsyncImage cancelled = ImGui::SFML::GetAsyncImage(other);
+    drawImages({image, cancelled});
+    CHECK(ImGui::SFML::GetAsyncImageState(image) == AsyncImageState::Loading);
+    CHECK(ImGui::SFML::GetAsyncImageState(cancelled) == AsyncImageState::Loading);
+
+    // the second image waits behind the uploads of the first one, and is cancelled once it's no
+    // longer drawn
+    int frames = 1;
+    for (; frames < 2000 && ImGui::SFML::GetAsyncImageState(image) == AsyncImageState::Loading; ++frames)
+    {
+        sf::sleep(sf::milliseconds(1));
+        drawImage(image);
+        if (frames == 2)
+            CHECK(ImGui::SFML::GetAsyncImageState(cancelled) == AsyncImageState::Unloaded);
+    }
+    REQUIRE(ImGui::SFML::GetAsyncImageState(image) == AsyncImageState::Ready);
+
+    // the 100 rows of the downscaled image were uploaded one per frame
+    CHECK(frames > 100);
+    const sf::Texture* texture = ImGui::SFML::GetAsyncImageTexture(image);
+    REQUIRE(texture != nullptr);
+    CHECK(texture->getSize() == sf::Vector2u(128, 100));
+    const sf::Image uploaded = texture->copyToImage();
+    CHECK(uploaded.getPixel(sf::Vector2u(0, 0)) == sf::Color::Red);
+    CHECK(uploaded.getPixel(sf::Vector2u(63, 99)) == sf::Color::Red);
+    CHECK(uploaded.getPixel(sf::Vector2u(64, 0)) == sf::Color::Blue);
+    CHECK(uploaded.getPixel(sf::Vector2u(127, 99)) == sf::Color::Blue);
+
+    // the late result of the cancelled request is dropped
+    for (int frame = 0; frame < 10; ++frame)
+        drawImage(image);
+    CHECK(ImGui::SFML::GetAsyncImageState(cancelled) == AsyncImageState::Unloaded);
+    CHECK(ImGui::SFML::GetAsyncImageTexture(cancelled) == nullptr);
+
+    ImGui::SFML::DisableAsyncImages();
+    std::filesystem::remove(path);
+    std::filesystem::remove(other);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "imgui-SFML.h"
+#include <imgui.h>
+
+#include <SFML/Window/Window.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdlib>
+
+// ImGui-SFML context of a window which is never opened: without focus the backend doesn't poll
+// input devices, and the font atlas is only built on the CPU, as uploading it needs an OpenGL
+// context. Frames end with ImGui::Render instead of ImGui::SFML::Render then.
+class HeadlessContext
+{
+public:
+    explicit HeadlessContext(const sf::Vector2f& displaySize, ImGui::SFML::InitOptions options = {})
+    {
+        options.loadDefaultFont = false;
+        REQUIRE(ImGui::SFML::Init(window, displaySize, options));
+
+        ImGuiIO& io    = ImGui::GetIO();
+        io.IniFilename = nullptr;
+
+        unsigned char* pixels = nullptr;
+        int            width  = 0;
+        int            height = 0;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    }
+
+    ~HeadlessContext()
+    {
+        ImGui::SFML::Shutdown();
+    }
+
+    HeadlessContext(const HeadlessContext&)            = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    sf::Window window;
+};
+
+// SFML aborts when it can't connect to a display to create an OpenGL context on
+[[nodiscard]] inline bool canCreateGlContext()
+{
+#if defined(__unix__) && !defined(__ANDROID__)
+    return std::getenv("DISPLAY") != nullptr;
+#else
+    return true;
+#endif
+}
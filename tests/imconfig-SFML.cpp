@@ -45,3 +45,54 @@ TEST_CASE("IM_VEC4_CLASS_EXTRA")
         CHECK(+color.a == 191);
     }
 }
+
+#ifdef IMGUI_SFML_COMPACT_VERTICES
+TEST_CASE("IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT")
+{
+    CHECK(sizeof(ImDrawVert) == 12);
+
+    ImDrawVert vert{};
+
+    SECTION("Positions have a quarter pixel precision")
+    {
+        vert.pos = ImVec2(12.25f, -3.5f);
+        CHECK(vert.pos.x.value == 49);
+        CHECK(vert.pos.y.value == -14);
+
+        const ImVec2 pos = vert.pos;
+        CHECK(pos.x == 12.25f);
+        CHECK(pos.y == -3.5f);
+
+        vert.pos.x = 100.1f;
+        CHECK(float(vert.pos.x) == 100.f);
+    }
+
+    SECTION("Positions are clamped")
+    {
+        vert.pos = ImVec2(10000.f, -10000.f);
+        CHECK(vert.pos.x.value == 32767);
+        CHECK(vert.pos.y.value == -32767);
+    }
+
+    SECTION("Texture coordinates keep texel edges exact")
+    {
+        vert.uv = ImVec2(0.f, 1.f);
+        CHECK(vert.uv.x.value == 0);
+        CHECK(vert.uv.y.value == 4096);
+
+        vert.uv.x = 3.f / 512.f;
+        CHECK(float(vert.uv.x) == 3.f / 512.f);
+    }
+
+    SECTION("Texture coordinates can repeat textures")
+    {
+        vert.uv = ImVec2(4.f, -2.5f);
+        const ImVec2 uv = vert.uv;
+        CHECK(uv.x == 4.f);
+        CHECK(uv.y == -2.5f);
+
+        vert.uv.x = 100.f;
+        CHECK(vert.uv.x.value == 32767);
+    }
+}
+#endif
@@ -0,0 +1,107 @@
+#include "headless-context.h"
+
+#include <SFML/Window/Event.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+struct FrameInput
+{
+    ImVec2               mousePos;
+    bool                 mouseDown{false};
+    bool                 keyDown{false};
+    std::vector<ImWchar> characters;
+};
+
+void captureFrameInput(void* userData)
+{
+    const ImGuiIO& io = ImGui::GetIO();
+    static_cast<std::vector<FrameInput>*>(userData)->push_back(
+        {io.MousePos,
+         io.MouseDown[0],
+         ImGui::IsKeyDown(ImGuiKey_A),
+         std::vector<ImWchar>(io.InputQueueCharacters.begin(), io.InputQueueCharacters.end())});
+}
+} // namespace
+
+TEST_CASE("Input recording")
+{
+    HeadlessContext context(sf::Vector2f(640.f, 480.f));
+    sf::Window&     window = context.window;
+    const ImGuiIO&  io     = ImGui::GetIO();
+
+    // events are only handled while the window has focus
+    ImGui::SFML::ProcessEvent(window, sf::Event::FocusGained{});
+
+    std::vector<FrameInput> recordedFrames;
+    std::stringstream       recording;
+    ImGui::SFML::StartInputRecording(recording);
+    for (int i = 0; i < 5; ++i)
+    {
+        const sf::Vector2i position(i, 2 * i);
+        ImGui::SFML::ProcessEvent(window, sf::Event::MouseMoved{position});
+        if (i == 1)
+            ImGui::SFML::ProcessEvent(window, sf::Event::MouseButtonPressed{sf::Mouse::Button::Left, position});
+        if (i == 3)
+            ImGui::SFML::ProcessEvent(window, sf::Event::MouseButtonReleased{sf::Mouse::Button::Left, position});
+        if (i == 2)
+            ImGui::SFML::ProcessEvent(window, sf::Event::KeyPressed{sf::Keyboard::Key::A, sf::Keyboard::Scancode::A});
+        if (i == 4)
+            ImGui::SFML::ProcessEvent(window, sf::Event::KeyReleased{sf::Keyboard::Key::A, sf::Keyboard::Scancode::A});
+        ImGui::SFML::ProcessEvent(window, sf::Event::TextEntered{static_cast<char32_t>(U'a' + i)});
+        ImGui::SFML::Update(position, sf::Vector2f(640.f, 480.f), sf::milliseconds(16));
+        captureFrameInput(&recordedFrames);
+        ImGui::Render();
+    }
+    ImGui::SFML::StopInputRecording();
+
+    // the replay must not depend on the focus the window has now
+    ImGui::SFML::ProcessEvent(window, sf::Event::FocusLost{});
+
+    SECTION("Replays every recorded frame")
+    {
+        int        builtFrames = 0;
+        const auto replayed    = ImGui::SFML::ReplayInput(
+            window,
+            recording,
+            [](void* userData) { ++*static_cast<int*>(userData); },
+            &builtFrames);
+        REQUIRE(replayed.has_value());
+        CHECK(*replayed == 5);
+        CHECK(builtFrames == 5);
+        CHECK(io.DisplaySize.x == 640.f);
+    }
+
+    SECTION("Replays the recorded input")
+    {
+        std::vector<FrameInput> replayedFrames;
+        REQUIRE(ImGui::SFML::ReplayInput(window, recording, captureFrameInput, &replayedFrames).has_value());
+        REQUIRE(replayedFrames.size() == recordedFrames.size());
+        for (std::size_t i = 0; i < recordedFrames.size(); ++i)
+        {
+            INFO("frame " << i);
+            CHECK(replayedFrames[i].mousePos.x == recordedFrames[i].mousePos.x);
+            CHECK(replayedFrames[i].mousePos.y == recordedFrames[i].mousePos.y);
+            CHECK(replayedFrames[i].mouseDown == recordedFrames[i].mouseDown);
+            CHECK(replayedFrames[i].keyDown == recordedFrames[i].keyDown);
+            CHECK(replayedFrames[i].characters == recordedFrames[i].characters);
+        }
+
+        // the recorded input did reach ImGui, ImGui may spread it over the following frames
+        const auto anyFrame = [&recordedFrames](auto predicate)
+        { return std::any_of(recordedFrames.begin(), recordedFrames.end(), predicate); };
+        CHECK(recordedFrames.back().mousePos.x == 4.f);
+        CHECK(anyFrame([](const FrameInput& frame) { return frame.mouseDown; }));
+        CHECK(anyFrame([](const FrameInput& frame) { return frame.keyDown; }));
+        CHECK(anyFrame([](const FrameInput& frame) { return !frame.characters.empty(); }));
+    }
+
+    SECTION("Rejects streams which aren't recordings")
+    {
+        std::istringstream garbage("not a recording");
+        CHECK(!ImGui::SFML::ReplayInput(window, garbage, nullptr).has_value());
+    }
+}
@@ -0,0 +1,69 @@
+#include "headless-context.h"
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include <algorithm>
+
+TEST_CASE("Large draw lists")
+{
+    const HeadlessContext context(sf::Vector2f(1280.f, 720.f));
+    const ImGuiIO&        io = ImGui::GetIO();
+
+    // the frame is also drawn if an OpenGL context can be created, which needs the font texture
+    const bool render = canCreateGlContext();
+    if (render)
+        REQUIRE(ImGui::SFML::UpdateFontTexture());
+
+    ImGui::SFML::Update(sf::Vector2i(), sf::Vector2f(1280.f, 720.f), sf::milliseconds(16));
+    ImGui::SetNextWindowPos(ImVec2(0.f, 0.f));
+    ImGui::SetNextWindowSize(io.DisplaySize);
+    ImGui::Begin("Node graph", nullptr, ImGuiWindowFlags_NoDecoration);
+
+    // 4 vertices per rectangle, about 1.2M vertices in a single draw list
+    constexpr int rectangles = 300'000;
+    ImDrawList*   drawList   = ImGui::GetWindowDrawList();
+    for (int i = 0; i < rectangles; ++i)
+    {
+        const ImVec2 min(static_cast<float>(i % 1200), static_cast<float>(i / 1200 % 700));
+        drawList->AddRectFilled(min, ImVec2(min.x + 1.f, min.y + 1.f), IM_COL32_WHITE);
+    }
+    ImGui::End();
+    ImGui::Render();
+
+    const ImDrawData* drawData = ImGui::GetDrawData();
+    REQUIRE(drawData->CmdListsCount > 0);
+    const ImDrawList* large = *std::max_element(drawData->CmdLists.begin(),
+                                                drawData->CmdLists.end(),
+                                                [](const ImDrawList* a, const ImDrawList* b)
+                                                { return a->VtxBuffer.Size < b->VtxBuffer.Size; });
+    REQUIRE(large->VtxBuffer.Size > 1'000'000);
+
+    const auto startsBatch = [](const ImDrawCmd& cmd) { return cmd.VtxOffset != 0; };
+#ifdef IMGUI_SFML_32BIT_INDICES
+    // the indices address the whole vertex buffer, so the rectangles are drawn as a single batch
+    CHECK(sizeof(ImDrawIdx) == 4);
+    CHECK(std::none_of(large->CmdBuffer.begin(), large->CmdBuffer.end(), startsBatch));
+    CHECK(*std::max_element(large->IdxBuffer.begin(), large->IdxBuffer.end()) > 0xFFFF);
+    CHECK(large->CmdBuffer.back().ElemCount >= rectangles * 6u);
+#else
+    // 16-bit indices split the list with vertex offsets
+    CHECK(std::any_of(large->CmdBuffer.begin(), large->CmdBuffer.end(), startsBatch));
+#endif
+
+    if (render)
+    {
+        // ImGui::Render was already called, the same draw data is drawn
+        sf::RenderTexture target;
+        REQUIRE(target.resize(sf::Vector2u(1280, 720)));
+        target.clear(sf::Color::Black);
+        ImGui::SFML::Render(target);
+        target.display();
+
+        // the rectangles cover the first 250 rows, the last ones come from the last batch
+        const sf::Image image = target.getTexture().copyToImage();
+        CHECK(image.getPixel(sf::Vector2u(100, 100)) == sf::Color::White);
+        CHECK(image.getPixel(sf::Vector2u(1100, 249)) == sf::Color::White);
+        CHECK(image.getPixel(sf::Vector2u(100, 400)) != sf::Color::White);
+    }
+}
@@ -0,0 +1,115 @@
+#include "headless-context.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("Sample series")
+{
+    std::vector<float> samples(100'000);
+    for (std::size_t i = 0; i < samples.size(); ++i)
+        samples[i] = std::sin(static_cast<float>(i) * 0.01f) * static_cast<float>(i % 97);
+
+    ImGui::SampleSeries series;
+    ImGui::AppendSamples(series, samples.data(), samples.size());
+
+    SECTION("Levels reduce pairs of the level below")
+    {
+        REQUIRE(!series.levels.empty());
+        CHECK(series.levels[0].min.size() == samples.size() / 2);
+        CHECK(series.levels[0].min[10] == std::min(samples[20], samples[21]));
+        CHECK(series.levels[1].max[10] == std::max({samples[40], samples[41], samples[42], samples[43]}));
+
+        const ImGui::SampleSeries::Level& top = series.levels.back();
+        CHECK(top.min.size() == 1);
+        CHECK(top.min[0] == *std::min_element(samples.begin(), samples.begin() + (1 << series.levels.size())));
+    }
+
+    SECTION("Streamed samples give the same levels")
+    {
+        ImGui::SampleSeries streamed;
+        for (std::size_t i = 0; i < samples.size(); i += 7)
+            ImGui::AppendSamples(streamed, samples.data() + i, std::min<std::size_t>(7, samples.size() - i));
+
+        REQUIRE(streamed.levels.size() == series.levels.size());
+        for (std::size_t level = 0; level < series.levels.size(); ++level)
+        {
+            CHECK(streamed.levels[level].min == series.levels[level].min);
+            CHECK(streamed.levels[level].max == series.levels[level].max);
+        }
+    }
+
+    SECTION("Plots a bar per column")
+    {
+        const HeadlessContext context(sf::Vector2f(640.f, 480.f));
+        ImGui::SFML::Update(sf::Vector2i(), sf::Vector2f(640.f, 480.f), sf::milliseconds(16));
+        ImGui::SetNextWindowPos(ImVec2(0.f, 0.f));
+        ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+        ImGui::Begin("Plot");
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        const int   before   = drawList->VtxBuffer.Size;
+        ImGui::PlotSeries(series, sf::Vector2f(200.f, 100.f));
+        const int plotted = drawList->VtxBuffer.Size - before;
+        ImGui::End();
+        ImGui::Render();
+
+        // the frame is drawn behind the 200 columns
+        CHECK(plotted > 200 * 4);
+        CHECK(plotted < 200 * 4 + 64);
+    }
+
+    SECTION("Bars span the samples of their column")
+    {
+        // whole values, so that the bars' extents are exact
+        std::vector<float> values(20'011);
+        std::uint32_t      seed = 12345;
+        for (float& value : values)
+        {
+            seed  = seed * 1664525u + 1013904223u;
+            value = static_cast<float>(static_cast<int>(seed >> 24) - 128);
+        }
+        ImGui::SampleSeries integers;
+        ImGui::AppendSamples(integers, values.data(), values.size());
+
+        // neither end of the plotted range nor the columns are aligned on the pyramid's blocks
+        ImGui::PlotSeriesSettings settings;
+        settings.thickness = 0.f;
+        settings.first     = 37;
+        settings.count     = 19'901;
+        settings.minValue  = -200.f;
+        settings.maxValue  = 200.f;
+        constexpr std::size_t columns = 97;
+
+        const HeadlessContext context(sf::Vector2f(640.f, 480.f));
+        ImGui::SFML::Update(sf::Vector2i(), sf::Vector2f(640.f, 480.f), sf::milliseconds(16));
+        ImGui::SetNextWindowPos(ImVec2(0.f, 0.f));
+        ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+        ImGui::Begin("Plot");
+        const ImDrawList* drawList = ImGui::GetWindowDrawList();
+        const int         before   = drawList->VtxBuffer.Size;
+        const float       baseline = ImGui::GetCursorScreenPos().y + 400.f;
+        ImGui::PlotSeries(integers, sf::Vector2f(static_cast<float>(columns), 400.f), settings);
+
+        // the frame's 4 vertices come first, then a quad per column
+        REQUIRE(drawList->VtxBuffer.Size - before == 4 + static_cast<int>(columns) * 4);
+        const std::size_t count = *settings.count;
+        for (std::size_t column = 0; column < columns; ++column)
+        {
+            // each bar also covers the last sample of the previous column
+            const std::size_t begin = settings.first + column * count / columns;
+            const std::size_t last  = settings.first + (column + 1) * count / columns;
+            const auto        from  = values.begin() + static_cast<std::ptrdiff_t>(column > 0 ? begin - 1 : begin);
+            const auto        to    = values.begin() + static_cast<std::ptrdiff_t>(last);
+            const auto [low, high]  = std::minmax_element(from, to);
+
+            // one pixel per unit, the top edge is the column's maximum
+            const ImDrawVert* quad = &drawList->VtxBuffer[before + 4 + static_cast<int>(column) * 4];
+            INFO("column " << column);
+            CHECK(baseline - ImVec2(quad[0].pos).y - 200.f == *high);
+            CHECK(baseline - ImVec2(quad[2].pos).y - 200.f == *low);
+        }
+        ImGui::End();
+        ImGui::Render();
+    }
+}